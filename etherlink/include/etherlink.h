@@ -5,6 +5,10 @@
  * Designed for low power/computation with user-definable message schemas.
  *
  * Frame format: [SYNC 0xA5] [MSG_ID] [LENGTH] [PAYLOAD...] [CRC8]
+ * Extended:     [SYNC 0xA6] [MSG_ID] [LENGTH lo] [LENGTH hi] [PAYLOAD...]
+ *               [CRC16 hi] [CRC16 lo]
+ * Checked:      [SYNC 0xA7/0xA8] [MSG_ID] [LENGTH] [HCHK] [PAYLOAD...]
+ *               [CRC16 hi lo / CRC32 LE]
  *
  * MIT License - https://github.com/user/etherlink
  */
@@ -16,6 +20,10 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,6 +35,57 @@ extern "C" {
 #define EL_SYNC_BYTE        0xA5
 #define EL_MAX_PAYLOAD      250     // Max payload size
 #define EL_FRAME_OVERHEAD   4       // SYNC + MSG_ID + LEN + CRC
+#define EL_SYNC_EXT         0xA6    // Extended frame sync (16-bit length, CRC-16)
+#define EL_EXT_OVERHEAD     6       // SYNC_EXT + MSG_ID + LEN16 + CRC16
+#define EL_EXT_MAX_PAYLOAD  65535   // Max extended payload size
+#define EL_SYNC_CRC16       0xA7    // Checked frame sync (header check, CRC-16)
+#define EL_SYNC_CRC32       0xA8    // Checked frame sync (header check, CRC-32)
+#define EL_CHK16_OVERHEAD   6       // SYNC + MSG_ID + LEN + HCHK + CRC16
+#define EL_CHK32_OVERHEAD   8       // SYNC + MSG_ID + LEN + HCHK + CRC32
+#define EL_MAX_FRAME        (EL_MAX_PAYLOAD + EL_CHK32_OVERHEAD) // Largest non-extended frame
+#define EL_RESCAN_SLACK     8       // Extra rx_buffer bytes needed with rescan
+#define EL_MAX_IOV          8       // Max payload segments per el_sendv call
+#define EL_TX_RING_MAX      32768   // Max TX ring size (power of two)
+#define EL_HANDLER_TABLE_SIZE 256   // Entries in a handler table (one per msg_id)
+
+// Static allocation (Kconfig: Etherlink -> Static allocation, or
+// -DEL_STATIC_ALLOC=1). The core never allocates; in this mode the
+// transports and helpers don't either and take every buffer and task stack
+// from caller storage (the EL_*_STORAGE_DEFINE macros in their headers).
+#if !defined(EL_STATIC_ALLOC) && defined(CONFIG_ETHERLINK_STATIC_ALLOC)
+#define EL_STATIC_ALLOC     1
+#endif
+#ifndef EL_STATIC_ALLOC
+#define EL_STATIC_ALLOC     0
+#endif
+
+// Trace hooks (Kconfig: Etherlink -> Trace hooks, or -DEL_TRACE=1). The
+// core then calls el_trace_hook, which the application provides, around
+// every parse call and every callback it dispatches. Off by default, and
+// the calls compile away entirely.
+#if !defined(EL_TRACE) && defined(CONFIG_ETHERLINK_TRACE)
+#define EL_TRACE            1
+#endif
+#ifndef EL_TRACE
+#define EL_TRACE            0
+#endif
+
+// CRC-8 kernels for EL_CRC8_IMPL (Kconfig: Etherlink -> CRC-8
+// implementation). With EL_CRC8_BENCH=1 (Kconfig: CRC-8 kernel benchmark)
+// every kernel is compiled in and el_crc8_kernel runs any of them, so one
+// build can compare them; that costs the tables of all four.
+#define EL_CRC8_TABLE       0       // 256-byte table, one lookup per byte
+#define EL_CRC8_SLICE4      1       // Slicing-by-4, 1 KB of tables
+#define EL_CRC8_SLICE8      2       // Slicing-by-8, 2 KB of tables
+#define EL_CRC8_BITWISE     3       // No tables, for flash-constrained builds
+#define EL_CRC8_KERNELS     4
+
+#if !defined(EL_CRC8_BENCH) && defined(CONFIG_ETHERLINK_CRC8_BENCH)
+#define EL_CRC8_BENCH       1
+#endif
+#ifndef EL_CRC8_BENCH
+#define EL_CRC8_BENCH       0
+#endif
 
 /*******************************************************************************
  * Message ID Conventions
@@ -36,8 +95,25 @@ extern "C" {
 #define EL_MSG_PING         0x00    // Heartbeat/ping request
 #define EL_MSG_PONG         0x01    // Ping response
 #define EL_MSG_VERSION      0x02    // Protocol version query/response
+#define EL_MSG_DELTA        0x03    // Delta-coded payload (etherlink_codec.h)
+#define EL_MSG_REL_DATA     0x04    // Reliable channel data (etherlink_reliable.h)
+#define EL_MSG_REL_ACK      0x05    // Reliable channel selective ACK
+#define EL_MSG_OTA_BEGIN    0x06    // OTA image start, over the reliable channel (etherlink_ota.h)
+#define EL_MSG_OTA_DATA     0x07    // OTA image chunk
+#define EL_MSG_OTA_END      0x08    // OTA image complete
+#define EL_MSG_OTA_STATUS   0x09    // OTA state report (device -> host)
+#define EL_MSG_STATS        0x0A    // Statistics request (empty) / report (el_send_stats)
 #define EL_MSG_ERROR        0x0F    // Error response
 
+// EL_MSG_VERSION capability exchange (el_negotiate_frames):
+// [EL_CAPS_TAG] [EL_CAPS_QUERY or EL_CAPS_REPLY] [EL_CAP_* bits]
+#define EL_CAPS_TAG         0xCA    // EL_MSG_VERSION payload[0]
+#define EL_CAPS_QUERY       0x00    // Sender's capabilities, answer with yours
+#define EL_CAPS_REPLY       0x01    // Answer to EL_CAPS_QUERY
+#define EL_CAP_EXT_FRAMES   0x01    // Extended frames enabled
+#define EL_CAP_CRC16        0x02    // Accepts CRC-16 checked frames
+#define EL_CAP_CRC32        0x04    // Accepts CRC-32 checked frames
+
 // User-defined ranges:
 // 0x10 - 0x7F: Telemetry (device -> host)
 // 0x80 - 0xFE: Commands (host -> device)
@@ -50,11 +126,48 @@ extern "C" {
 /**
  * Callback when a complete message is received
  * @param msg_id Message type identifier
- * @param payload Pointer to payload data (valid only during callback)
+ * @param payload Pointer to payload data (valid only during callback; may
+ *                point into the buffer passed to el_process_bytes)
  * @param len Payload length in bytes
  */
 typedef void (*el_on_message_t)(uint8_t msg_id, const void *payload, uint8_t len);
 
+/**
+ * Payload codec state (etherlink_codec.h)
+ */
+typedef struct el_codec_s el_codec_t;
+
+/**
+ * Reliable channel state (etherlink_reliable.h)
+ */
+typedef struct el_rel_s el_rel_t;
+
+/**
+ * Per-message handler (see el_register_handler)
+ * @param user User pointer given at registration
+ * @param msg_id Message type identifier
+ * @param payload Pointer to payload data (valid only during callback)
+ * @param len Payload length in bytes, at least the registered min_len
+ */
+typedef void (*el_handler_t)(void *user, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * Handler table entry
+ */
+typedef struct {
+    el_handler_t fn;                // NULL = unregistered
+    void *user;
+    uint8_t min_len;                // Shorter payloads are rejected before fn
+} el_handler_entry_t;
+
+/**
+ * Callback for payloads longer than EL_MAX_PAYLOAD (extended frames)
+ * @param msg_id Message type identifier
+ * @param payload Pointer to payload data (valid only during callback)
+ * @param len Payload length in bytes
+ */
+typedef void (*el_on_message_ext_t)(uint8_t msg_id, const void *payload, size_t len);
+
 /**
  * Callback to send raw bytes (implement for your transport)
  * @param data Pointer to data to send
@@ -62,6 +175,125 @@ typedef void (*el_on_message_t)(uint8_t msg_id, const void *payload, uint8_t len
  */
 typedef void (*el_send_bytes_t)(const uint8_t *data, size_t len);
 
+/**
+ * Scatter-gather segment
+ */
+typedef struct {
+    const void *data;               // Segment data (can be NULL if len is 0)
+    size_t len;                     // Segment length in bytes
+} el_iovec_t;
+
+/**
+ * Callback to send one frame as a list of segments (gather-capable transports)
+ * The segments must go out back to back, in order, as a single frame.
+ * @param user User pointer from el_config_t.send_user
+ * @param iov Segments to send
+ * @param iovcnt Number of segments
+ */
+typedef void (*el_send_bytesv_t)(void *user, const el_iovec_t *iov, size_t iovcnt);
+
+/**
+ * Callback to push out any frames the transport is holding back (optional)
+ * @param user User pointer from el_config_t.send_user
+ */
+typedef void (*el_flush_t)(void *user);
+
+/**
+ * Transport hook for the asynchronous TX ring
+ * @param user User pointer given to el_tx_attach
+ */
+typedef void (*el_tx_hook_t)(void *user);
+
+/**
+ * What el_send does when the TX ring has no room for a frame
+ */
+typedef enum {
+    EL_TX_DROP_NEWEST,      // Reject the new frame (default)
+    EL_TX_DROP_OLDEST,      // Discard queued frames not yet taken by the transport
+                            // (single producer only; el_init rejects it otherwise)
+    EL_TX_BLOCK,            // Wait for the transport to drain (needs a wait hook)
+} el_tx_policy_t;
+
+/**
+ * TX ring (asynchronous TX mode)
+ * Positions are free-running counters; access is lock-free.
+ */
+typedef struct {
+    uint8_t *buf;                   // Storage, size is a power of two
+    uint32_t size;                  // Storage size in bytes (0 = ring disabled)
+    uint32_t head;                  // Producer position (end of last frame)
+    uint32_t cons;                  // Consumer positions: read << 16 | tail
+    uint32_t reserve;               // Multi-producer: end of reserved space
+    bool multi_producer;            // Frames are reserved with an atomic CAS
+    el_tx_policy_t policy;          // Full-ring policy
+    el_tx_hook_t notify;            // Transport: frames available
+    el_tx_hook_t wait;              // Transport: yield while ring is full
+    void *hook_user;                // User pointer for the hooks
+} el_tx_ring_t;
+
+/**
+ * Integrity of frames with payloads up to EL_MAX_PAYLOAD
+ */
+typedef enum {
+    EL_CRC_8,               // Standard frames (default)
+    EL_CRC_16,              // Checked frames with CRC-16
+    EL_CRC_32,              // Checked frames with CRC-32
+} el_crc_t;
+
+/**
+ * Statistics snapshot (el_get_stats)
+ *
+ * Counters are free-running and wrap; diff two snapshots for rates.
+ */
+typedef struct {
+    // Receive
+    uint32_t rx_frames;             // Valid frames
+    uint32_t rx_bytes;              // Bytes passed to the parser
+    uint32_t rx_crc_errors;         // Frames that failed their CRC
+    uint32_t rx_len_errors;         // Headers with a bad length or header check
+    uint32_t rx_sync_discarded;     // Bytes skipped while hunting for sync
+    uint32_t rx_unhandled;          // Valid frames no callback took
+    uint32_t rx_bad_length;         // Valid frames shorter than their handler's min_len
+    uint32_t rx_filtered;           // Frames discarded by the ID filter
+
+    // Transmit
+    uint32_t tx_frames;             // Frames sent or queued
+    uint32_t tx_bytes;              // Bytes in those frames, framing included
+    uint32_t tx_drops;              // Frames dropped on a full TX ring
+    uint32_t tx_high_water;         // Most bytes ever queued in the TX ring
+
+    // Dispatch
+    uint32_t rx_cb_max;             // Longest callback, in cb_clock ticks (0 = not timed)
+
+    // Transport (filled by the transport's stats hook, 0 without one)
+    uint32_t link_rx_drops;         // Received data lost before the parser
+    uint32_t link_tx_drops;         // Frames the transport failed to send
+    uint32_t link_queue_high_water; // Deepest transport RX/TX queue, in its own units
+} el_stats_t;
+
+/**
+ * Transport hook that fills the link_* fields of a snapshot
+ * @param user User pointer given to el_set_stats_hook
+ * @param stats Snapshot being built
+ */
+typedef void (*el_stats_hook_t)(void *user, el_stats_t *stats);
+
+/**
+ * Free-running tick counter used to time callbacks (e.g. a CPU cycle count)
+ * @return Current tick count
+ */
+typedef uint32_t (*el_clock_t)(void);
+
+/**
+ * Trace hook events (EL_TRACE builds)
+ */
+typedef enum {
+    EL_TRACE_PARSE_BEGIN,       // el_process_byte(s) entered (info: byte count)
+    EL_TRACE_PARSE_END,         // el_process_byte(s) returning (info: byte count)
+    EL_TRACE_DISPATCH_BEGIN,    // About to run a frame callback (info: msg_id)
+    EL_TRACE_DISPATCH_END,      // Frame callback returned (info: msg_id)
+} el_trace_event_t;
+
 /**
  * Parser state machine states
  */
@@ -69,8 +301,12 @@ typedef enum {
     EL_STATE_IDLE,          // Waiting for sync byte
     EL_STATE_GOT_SYNC,      // Got sync, waiting for msg_id
     EL_STATE_GOT_ID,        // Got msg_id, waiting for length
+    EL_STATE_GOT_LEN_LO,    // Extended: got low length byte, waiting for high
+    EL_STATE_GOT_LEN_CHK,   // Checked: got length, waiting for header check
     EL_STATE_GOT_LEN,       // Got length, receiving payload
-    EL_STATE_GOT_PAYLOAD,   // Got payload, waiting for CRC
+    EL_STATE_GOT_PAYLOAD,   // Got payload, waiting for CRC (multi-byte: first byte)
+    EL_STATE_GOT_CRC_HI,    // Multi-byte CRC: receiving the remaining bytes
+    EL_STATE_SKIP,          // Filtered ID, discarding payload + CRC
 } el_state_t;
 
 /**
@@ -79,28 +315,123 @@ typedef enum {
 typedef struct {
     // Configuration
     el_on_message_t on_message;     // Message received callback
+    el_on_message_ext_t on_message_ext; // Extended payload callback
     el_send_bytes_t send_bytes;     // Byte transmission callback
+    el_send_bytesv_t send_bytesv;   // Gather transmission callback
+    el_flush_t flush;               // Transport flush callback
+    void *send_user;                // User pointer for send_bytesv/flush
+    el_handler_entry_t *handlers;   // Handler table indexed by msg_id (or NULL)
+    uint32_t rx_filter[EL_HANDLER_TABLE_SIZE / 32]; // Set bit = discard that msg_id
+    el_codec_t *codec;              // Decodes EL_MSG_DELTA frames (or NULL)
+    el_rel_t *reliable;             // Takes EL_MSG_REL_* frames (set by el_rel_init)
+    uint32_t *rx_id_counts;         // Valid frames per msg_id (or NULL)
+    el_clock_t cb_clock;            // Times callbacks into rx_cb_max (or NULL)
+    el_stats_hook_t stats_hook;     // Transport part of el_get_stats (or NULL)
+    void *stats_user;               // User pointer for stats_hook
+
+    bool ext_frames;                // Extended frames enabled
+    bool auto_pong;                 // Answer EL_MSG_PING in the parser
+    bool auto_stats;                // Answer an empty EL_MSG_STATS in the parser
+    bool rescan;                    // Re-parse the bytes of rejected frames
+    el_crc_t rx_crc;                // Strongest checked frame accepted (EL_CRC_8 = none)
+    el_crc_t tx_crc;                // Frame type el_send uses (see el_negotiate_frames)
+    uint8_t peer_caps;              // EL_CAP_* bits from the peer's last exchange
 
     // Parser state
     el_state_t state;
+    bool rx_ext;                    // Frame being parsed is extended
+    uint8_t rx_crc_len;             // CRC bytes of the frame being parsed (1, 2 or 4)
+    uint8_t crc_left;               // CRC bytes still to come in EL_STATE_GOT_CRC_HI
+    uint8_t rx_hchk;                // Checked frames: expected header check
     uint8_t msg_id;
-    uint8_t payload_len;
-    uint8_t payload_idx;
-    uint8_t rx_buffer[EL_MAX_PAYLOAD];
-    uint8_t running_crc;
+    uint16_t payload_len;
+    uint16_t payload_idx;
+    uint8_t *rx_buf;                // Frame buffer (rx_buffer or caller's)
+    uint16_t rx_buf_size;           // Payload capacity of rx_buf
+    uint16_t rx_base;               // Payload offset in rx_buf (rescan keeps the header first)
+    uint16_t rx_raw;                // Rescan: bytes after the sync kept in rx_buf
+    uint16_t rx_replay;             // Rescan: bytes of a rejected frame to parse again
+    uint8_t rx_buffer[EL_MAX_PAYLOAD + EL_RESCAN_SLACK];
+    uint32_t running_crc;           // CRC-8 in the low byte, CRC-16 or CRC-32
+    uint32_t skip_left;             // Bytes left to discard in EL_STATE_SKIP
 
-    // Statistics
+    // Asynchronous TX
+    el_tx_ring_t tx_ring;
+
+    // Statistics (see el_stats_t)
     uint32_t rx_frames;
-    uint32_t rx_errors;
+    uint32_t rx_errors;             // rx_crc_errors + rx_len_errors
+    uint32_t rx_crc_errors;
+    uint32_t rx_len_errors;
+    uint32_t rx_sync_discarded;
+    uint32_t rx_bytes;
+    uint32_t rx_unhandled;          // Valid frames with no handler for their ID
+    uint32_t rx_bad_length;         // Valid frames with a length their handler rejects
+    uint32_t rx_filtered;           // Frames discarded unread by the ID filter
+    uint32_t rx_cb_max;             // Longest callback in cb_clock ticks
     uint32_t tx_frames;
+    uint32_t tx_bytes;
+    uint32_t tx_drops;              // Frames dropped on a full TX ring
+    uint32_t tx_high_water;         // Most bytes ever queued in the TX ring
 } el_ctx_t;
 
 /**
  * Configuration for el_init
  */
 typedef struct {
-    el_on_message_t on_message;     // Required: message callback
-    el_send_bytes_t send_bytes;     // Required: transmit callback
+    el_on_message_t on_message;     // Message callback (required unless handlers set;
+                                    // with handlers, receives unregistered IDs)
+    el_on_message_ext_t on_message_ext; // Optional: payloads over EL_MAX_PAYLOAD
+    el_send_bytes_t send_bytes;     // Transmit callback (this or send_bytesv required)
+    el_send_bytesv_t send_bytesv;   // Optional: gather transmit, preferred when set
+    el_flush_t flush;               // Optional: flush for batching transports
+    void *send_user;                // Optional: passed to send_bytesv/flush
+
+    // Optional per-ID dispatch: el_register_handler fills this table,
+    // which must hold EL_HANDLER_TABLE_SIZE entries. Cleared by el_init.
+    el_handler_entry_t *handlers;
+
+    // Optional payload codec: EL_MSG_DELTA frames are expanded before
+    // dispatch (see etherlink_codec.h)
+    el_codec_t *codec;
+
+    // Optional extended frames, for payloads over EL_MAX_PAYLOAD. Both
+    // peers must enable them; payloads up to EL_MAX_PAYLOAD still use
+    // the standard frame.
+    bool ext_frames;                // Send and accept extended frames
+    uint8_t *rx_buffer;             // Payload buffer (NULL = built-in, EL_MAX_PAYLOAD)
+    size_t rx_buffer_size;          // EL_MAX_PAYLOAD .. EL_EXT_MAX_PAYLOAD (plus
+                                    // EL_RESCAN_SLACK with rescan)
+
+    // Optional stronger framing for noisy links. Checked frames carry a
+    // header check byte, so a corrupt length is rejected before any
+    // payload is read, and protect the payload with CRC-16 or CRC-32.
+    // el_send keeps sending standard frames until el_negotiate_frames has
+    // agreed on a CRC with the peer. With rescan, the bytes of a frame
+    // that fails its checks are parsed again from the byte after its
+    // sync, so real frames hidden behind a false sync are not lost.
+    el_crc_t frame_crc;             // Strongest checked frame accepted (EL_CRC_8 = none)
+    bool rescan;                    // Re-parse rejected frames
+
+    // Optional: answer every EL_MSG_PING with an EL_MSG_PONG carrying the
+    // same payload, from the parser, before any handler sees it
+    bool auto_pong;
+
+    // Optional statistics (see el_get_stats). rx_id_counts must hold
+    // EL_HANDLER_TABLE_SIZE counters and is cleared by el_init. With
+    // cb_clock set (e.g. esp_cpu_get_cycle_count), every handler and
+    // on_message call is timed and the longest kept in rx_cb_max.
+    uint32_t *rx_id_counts;         // Valid frames per msg_id (NULL = not counted)
+    el_clock_t cb_clock;            // Callback timer (NULL = not timed)
+    bool auto_stats;                // Answer an empty EL_MSG_STATS with el_send_stats
+
+    // Optional asynchronous TX: el_send enqueues frames here and the
+    // transport attached with el_tx_attach drains them from its own task
+    uint8_t *tx_ring;               // Ring storage (NULL = synchronous TX)
+    size_t tx_ring_size;            // Power of two, up to EL_TX_RING_MAX
+    el_tx_policy_t tx_policy;       // Full-ring policy
+    bool tx_multi_producer;         // Allow el_send from several tasks/cores
+                                    // (not with EL_TX_DROP_OLDEST)
 } el_config_t;
 
 /*******************************************************************************
@@ -115,6 +446,92 @@ typedef struct {
  */
 bool el_init(el_ctx_t *ctx, const el_config_t *config);
 
+/**
+ * Bind a context's TX side to a transport instance
+ *
+ * Replaces send_bytesv, flush and send_user given to el_init. Use this when
+ * the transport instance is created after the context, e.g.
+ * el_bind_transport(&ctx, el_uart_send_rawv, NULL, uart).
+ *
+ * @param ctx Context
+ * @param send_bytesv Gather transmit callback
+ * @param flush Flush callback (can be NULL)
+ * @param user Passed to both callbacks
+ */
+void el_bind_transport(el_ctx_t *ctx, el_send_bytesv_t send_bytesv, el_flush_t flush, void *user);
+
+/**
+ * Register a handler for one message ID
+ *
+ * Requires a context initialized with a handler table. Frames with this
+ * msg_id are passed to fn instead of on_message, and frames whose payload
+ * is shorter than min_len are counted in rx_bad_length and dropped, so fn
+ * can cast the payload without checking its length. Register before
+ * receive starts, or from the task that runs the parser.
+ *
+ * @param ctx Context
+ * @param msg_id Message ID to handle
+ * @param fn Handler, or NULL to unregister
+ * @param user Passed to fn
+ * @param min_len Minimum payload length
+ * @return true on success, false if ctx has no handler table
+ */
+bool el_register_handler(el_ctx_t *ctx, uint8_t msg_id, el_handler_t fn,
+                         void *user, uint8_t min_len);
+
+/**
+ * Discard or accept a range of message IDs
+ *
+ * Frames with a discarded ID are skipped as soon as their header is read:
+ * the payload is neither buffered nor CRC-checked and no callback runs.
+ * They are counted in rx_filtered. All IDs are accepted after el_init.
+ *
+ * @param ctx Context
+ * @param first_id First ID of the range
+ * @param last_id Last ID of the range (inclusive)
+ * @param drop true to discard, false to accept
+ */
+void el_set_filter(el_ctx_t *ctx, uint8_t first_id, uint8_t last_id, bool drop);
+
+/**
+ * Discard every ID that has no registered handler
+ *
+ * Only applies to contexts with a handler table and no on_message, where
+ * such frames would otherwise be parsed just to be counted in
+ * rx_unhandled. Call again after registering new handlers.
+ *
+ * @param ctx Context
+ */
+void el_filter_unhandled(el_ctx_t *ctx);
+
+/**
+ * Agree on frame integrity with the peer through EL_MSG_VERSION
+ *
+ * Sends this side's capabilities as an EL_CAPS_QUERY. A peer whose context
+ * has frame_crc set answers from its parser, and both sides switch el_send
+ * to the strongest checked frame they both accept; ctx->tx_crc shows the
+ * result once the reply has been parsed. A peer without checked frames
+ * does not answer and frames stay standard. Ask again after the peer
+ * restarts.
+ *
+ * @param ctx Context with frame_crc set
+ * @return true if the query was sent
+ */
+bool el_negotiate_frames(el_ctx_t *ctx);
+
+/**
+ * Choose the frames el_send uses for payloads up to EL_MAX_PAYLOAD
+ *
+ * For links whose ends are configured alike and skip the negotiation. The
+ * peer must accept the chosen frames.
+ *
+ * @param ctx Context
+ * @param crc EL_CRC_8 for standard frames, or a checked frame CRC
+ * @return true on success, false if crc is invalid or the TX ring is
+ *         smaller than EL_MAX_FRAME
+ */
+bool el_set_tx_crc(el_ctx_t *ctx, el_crc_t crc);
+
 /**
  * Reset parser state (call on communication errors/reconnect)
  * @param ctx Context
@@ -130,6 +547,10 @@ void el_process_byte(el_ctx_t *ctx, uint8_t byte);
 
 /**
  * Process multiple received bytes
+ *
+ * Frames contained entirely in data are delivered without being copied
+ * into the context; frames split across calls are reassembled internally.
+ *
  * @param ctx Context
  * @param data Pointer to received data
  * @param len Number of bytes
@@ -142,10 +563,162 @@ void el_process_bytes(el_ctx_t *ctx, const uint8_t *data, size_t len);
  * @param msg_id Message type identifier
  * @param payload Payload data (can be NULL if len is 0)
  * @param len Payload length (0-250)
- * @return true on success, false if payload too large
+ * @return true on success, false if payload too large (or, in
+ *         asynchronous TX mode, if the frame was dropped)
  */
 bool el_send(el_ctx_t *ctx, uint8_t msg_id, const void *payload, uint8_t len);
 
+/**
+ * Send a message whose payload is gathered from several segments
+ *
+ * With a send_bytesv transport the segments are passed through without
+ * being staged; the CRC is computed incrementally across them. A payload
+ * over EL_MAX_PAYLOAD is sent as an extended frame if ext_frames is set.
+ *
+ * @param ctx Context
+ * @param msg_id Message type identifier
+ * @param iov Payload segments, concatenated in order
+ * @param iovcnt Number of segments (0-EL_MAX_IOV)
+ * @return true on success, false if payload too large or too many segments
+ */
+bool el_sendv(el_ctx_t *ctx, uint8_t msg_id, const el_iovec_t *iov, size_t iovcnt);
+
+/**
+ * Send a message of any size up to EL_EXT_MAX_PAYLOAD
+ *
+ * Payloads over EL_MAX_PAYLOAD go out as one extended frame and require
+ * ext_frames; shorter ones are sent exactly like el_send.
+ *
+ * @param ctx Context
+ * @param msg_id Message type identifier
+ * @param payload Pointer to payload data
+ * @param len Payload length
+ * @return true if sent successfully
+ */
+bool el_send_ext(el_ctx_t *ctx, uint8_t msg_id, const void *payload, size_t len);
+
+/*******************************************************************************
+ * Statistics
+ ******************************************************************************/
+
+#define EL_STATS_VERSION    1       // First byte of an EL_MSG_STATS report
+#define EL_STATS_FIELDS     16      // uint32_t fields that follow it
+#define EL_STATS_REPORT_LEN (1 + 4 * EL_STATS_FIELDS)
+
+/**
+ * Take a snapshot of a context's counters
+ *
+ * Includes the transport's drop and queue counters when the transport has
+ * registered a stats hook. Can be called from any task; each counter is
+ * read once, so the snapshot is not atomic as a whole.
+ *
+ * @param ctx Context
+ * @param stats Filled with the snapshot
+ */
+void el_get_stats(const el_ctx_t *ctx, el_stats_t *stats);
+
+/**
+ * Register the transport hook that fills the link_* fields of el_get_stats
+ *
+ * Called by transports when they bind to a context.
+ *
+ * @param ctx Context
+ * @param hook Hook, or NULL to remove it
+ * @param user Passed to hook
+ */
+void el_set_stats_hook(el_ctx_t *ctx, el_stats_hook_t hook, void *user);
+
+/**
+ * Send a stats snapshot as an EL_MSG_STATS report
+ *
+ * The payload is EL_STATS_VERSION followed by the el_stats_t fields as
+ * little-endian uint32_t, in declaration order (EL_STATS_REPORT_LEN
+ * bytes). Contexts with auto_stats send one whenever an empty
+ * EL_MSG_STATS arrives; call this from a timer to stream them instead.
+ *
+ * @param ctx Context
+ * @return true if the report was sent
+ */
+bool el_send_stats(el_ctx_t *ctx);
+
+/**
+ * Decode an EL_MSG_STATS report from a peer
+ * @param payload Report payload
+ * @param len Payload length
+ * @param stats Filled with the peer's snapshot
+ * @return true on success, false if the report is too short or of another version
+ */
+bool el_stats_decode(const void *payload, uint8_t len, el_stats_t *stats);
+
+#if EL_TRACE
+/**
+ * Trace hook, implemented by the application in EL_TRACE builds
+ *
+ * Runs inline on the parsing task, so keep it short (e.g. store into a
+ * ring buffer or toggle a GPIO).
+ *
+ * @param event Event
+ * @param ctx Context
+ * @param info Byte count for parse events, msg_id for dispatch events
+ * @param cycles CPU cycle count at the event (0 where no counter is known;
+ *               define EL_TRACE_CYCLES() to supply one)
+ */
+void el_trace_hook(el_trace_event_t event, const el_ctx_t *ctx, uint32_t info, uint32_t cycles);
+#endif
+
+/*******************************************************************************
+ * Asynchronous TX (transport side)
+ ******************************************************************************/
+
+/**
+ * Attach a transport to the context's TX ring
+ *
+ * Called by transports that drain the ring from a sender task. The notify
+ * hook runs after each frame is queued (from the producer's task); the wait
+ * hook runs while el_send blocks under EL_TX_BLOCK.
+ *
+ * @param ctx Context with a TX ring
+ * @param notify Called when frames are available (can be NULL)
+ * @param wait Called while waiting for space (can be NULL)
+ * @param user Passed to the hooks
+ * @return true on success, false if the context has no TX ring
+ */
+bool el_tx_attach(el_ctx_t *ctx, el_tx_hook_t notify, el_tx_hook_t wait, void *user);
+
+/**
+ * Check whether the context queues frames in a TX ring
+ * @param ctx Context
+ * @return true if a TX ring is configured
+ */
+bool el_tx_async(const el_ctx_t *ctx);
+
+/**
+ * Take all queued frames for transmission
+ *
+ * Fills span with one or two segments (two when the data wraps) covering
+ * whole frames. In multi-producer mode the claim stops at the first frame
+ * that is reserved but not yet published. The bytes stay valid until el_tx_release, and frames
+ * taken this way are never dropped. Single consumer only.
+ *
+ * @param ctx Context
+ * @param span Filled with the segments to send
+ * @param count Filled with the number of segments (0-2)
+ * @return Total bytes taken, 0 if the ring is empty
+ */
+size_t el_tx_claim(el_ctx_t *ctx, el_iovec_t span[2], size_t *count);
+
+/**
+ * Return the space taken by the last el_tx_claim to the producer
+ * @param ctx Context
+ */
+void el_tx_release(el_ctx_t *ctx);
+
+/**
+ * Push out frames the transport is batching (no-op without a flush callback)
+ * @param ctx Context
+ */
+void el_flush(el_ctx_t *ctx);
+
 /*******************************************************************************
  * Utility Functions
  ******************************************************************************/
@@ -158,6 +731,22 @@ bool el_send(el_ctx_t *ctx, uint8_t msg_id, const void *payload, uint8_t len);
  */
 uint8_t el_crc8(const uint8_t *data, size_t len);
 
+/**
+ * Calculate CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of extended frames
+ * @param data Data buffer
+ * @param len Data length
+ * @return CRC-16 value
+ */
+uint16_t el_crc16(const uint8_t *data, size_t len);
+
+/**
+ * Calculate CRC-32/ISO-HDLC (poly 0x04C11DB7 reflected, as zlib) of checked frames
+ * @param data Data buffer
+ * @param len Data length
+ * @return CRC-32 value
+ */
+uint32_t el_crc32(const uint8_t *data, size_t len);
+
 /**
  * Update running CRC with one byte
  * @param crc Current CRC value
@@ -166,6 +755,21 @@ uint8_t el_crc8(const uint8_t *data, size_t len);
  */
 uint8_t el_crc8_update(uint8_t crc, uint8_t byte);
 
+#if EL_CRC8_BENCH
+/**
+ * Calculate CRC-8/CCITT with a given kernel (EL_CRC8_BENCH builds)
+ *
+ * For comparing the kernels in one build; el_crc8 keeps using
+ * EL_CRC8_IMPL. All kernels return the same CRC.
+ *
+ * @param impl EL_CRC8_TABLE, EL_CRC8_SLICE4, EL_CRC8_SLICE8 or EL_CRC8_BITWISE
+ * @param data Data buffer
+ * @param len Data length
+ * @return CRC-8 value
+ */
+uint8_t el_crc8_kernel(int impl, const uint8_t *data, size_t len);
+#endif
+
 /*******************************************************************************
  * Helper Macros for Message Definition
  ******************************************************************************/
@@ -191,6 +795,13 @@ uint8_t el_crc8_update(uint8_t crc, uint8_t byte);
 #define EL_CAST(type, payload, len) \
     ((len) >= sizeof(type) ? (const type *)(payload) : NULL)
 
+/**
+ * Register a handler whose payload is at least sizeof(type)
+ * Usage: EL_REGISTER_HANDLER(ctx, MSG_ID, my_msg_t, on_my_msg, NULL);
+ */
+#define EL_REGISTER_HANDLER(ctx, msg_id, type, fn, user) \
+    el_register_handler((ctx), (msg_id), (fn), (user), sizeof(type))
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,130 @@
+/**
+ * Etherlink Payload Codec
+ *
+ * Optional compact encoding for slowly changing telemetry. A stream is one
+ * msg_id whose payload is a fixed sequence of little-endian integer fields.
+ * el_codec_send() codes each field as a zigzag varint of its difference to
+ * the previous frame of that stream and sends the result as EL_MSG_DELTA:
+ *
+ *   [msg_id] [seq] [varint per field...]
+ *
+ * Every keyframe_interval frames, and whenever coding would not save
+ * bytes, the payload goes out unchanged under its own msg_id instead. A
+ * receiver without the codec therefore still sees every keyframe. The
+ * receiving context expands EL_MSG_DELTA frames before dispatch, so
+ * on_message and handlers only ever see the original msg_id and payload.
+ * A delta whose seq does not follow the last one (frame lost) is dropped,
+ * as are all deltas until the next keyframe.
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#ifndef ETHERLINK_CODEC_H
+#define ETHERLINK_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "etherlink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EL_CODEC_KEYFRAME_DEFAULT   32  // Frames per keyframe when interval is 0
+
+/**
+ * One coded message stream
+ *
+ * fields, tx_ref and rx_ref are caller storage; tx_ref and rx_ref hold one
+ * payload each and may be NULL on the side that never sends / receives.
+ */
+typedef struct {
+    uint8_t msg_id;
+    const uint8_t *fields;          // Width of each field in bytes (1, 2 or 4)
+    uint8_t field_count;
+    uint8_t keyframe_interval;      // Raw keyframe every N frames (0 = default)
+    uint8_t *tx_ref;                // Last payload sent
+    uint8_t *rx_ref;                // Last payload received (decode output)
+
+    // State (set by el_codec_init)
+    uint8_t size;                   // Payload size (sum of field widths)
+    uint8_t tx_seq;                 // Frames sent since the last keyframe
+    uint8_t rx_seq;
+    bool tx_valid;
+    bool rx_valid;
+} el_codec_stream_t;
+
+/**
+ * Codec context, shared by the TX and RX side of one el_ctx_t
+ */
+struct el_codec_s {
+    el_codec_stream_t *streams;
+    size_t stream_count;
+
+    // Statistics: compare tx_payload_bytes with tx_raw_bytes for the
+    // saving over sending the structs as they are
+    uint32_t tx_raw_bytes;          // Payload bytes the frames would take raw
+    uint32_t tx_payload_bytes;      // Payload bytes actually sent
+    uint32_t tx_keyframes;
+    uint32_t tx_deltas;
+    uint32_t rx_deltas;             // Delta frames expanded
+    uint32_t rx_dropped;            // Deltas dropped (gap, unknown stream, corrupt)
+};
+
+/**
+ * Initialize a codec over caller-provided streams
+ *
+ * Pass the codec in el_config_t.codec (receive side) and send through
+ * el_codec_send() (transmit side).
+ *
+ * @param codec Codec to initialize
+ * @param streams Stream table (kept by reference)
+ * @param count Number of streams
+ * @return true on success, false on invalid field widths, a payload over
+ *         EL_MAX_PAYLOAD or a duplicate msg_id
+ */
+bool el_codec_init(el_codec_t *codec, el_codec_stream_t *streams, size_t count);
+
+/**
+ * Send a message, delta-coded when it belongs to a stream
+ *
+ * Messages without a stream, or whose length differs from the stream's
+ * payload size, are passed to el_send() unchanged. Call from one task per
+ * stream.
+ *
+ * @param ctx Context
+ * @param codec Codec
+ * @param msg_id Message type identifier
+ * @param payload Payload data
+ * @param len Payload length
+ * @return true if sent successfully
+ */
+bool el_codec_send(el_ctx_t *ctx, el_codec_t *codec, uint8_t msg_id,
+                   const void *payload, uint8_t len);
+
+/**
+ * Forget reference frames (e.g. on reconnect), forcing keyframes
+ * @param codec Codec
+ */
+void el_codec_reset(el_codec_t *codec);
+
+/**
+ * Expand a received frame (called by the parser before dispatch)
+ *
+ * Rewrites EL_MSG_DELTA frames into their original msg_id and payload
+ * and records raw frames of coded streams as the next reference.
+ *
+ * @param codec Codec
+ * @param msg_id In: received ID, out: ID to dispatch
+ * @param payload In: received payload, out: payload to dispatch
+ * @param len In: received length, out: length to dispatch
+ * @return false if the frame must be dropped
+ */
+bool el_codec_rx(el_codec_t *codec, uint8_t *msg_id, const uint8_t **payload, uint8_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERLINK_CODEC_H
@@ -0,0 +1,201 @@
+/**
+ * Etherlink Reliable Channel
+ *
+ * Optional delivery guarantee for bulk data (OTA images, log pulls) on top
+ * of any transport. Each message travels as an EL_MSG_REL_DATA frame with
+ * a 16-bit sequence number:
+ *
+ *   [seq lo] [seq hi] [msg_id] [payload...]
+ *
+ * Up to tx_window frames are in flight at once, each kept in a
+ * caller-provided slot until acknowledged. The receiver answers with
+ * EL_MSG_REL_ACK frames carrying the next sequence number it expects and a
+ * bitmap of the frames after it that it already holds:
+ *
+ *   [next lo] [next hi] [bitmap, 4 bytes LE: bit i = seq next + 1 + i]
+ *
+ * A gap in the bitmap below a received frame is a NACK: the sender
+ * retransmits the missing frame at once instead of waiting for its timer.
+ * Frames that are not acknowledged at all are retransmitted after an RTO
+ * derived from measured round-trip times (RFC 6298, Karn's rule), doubling
+ * on each timeout. Frames received out of order are held in rx slots and
+ * handed to on_message strictly in sequence.
+ *
+ * Both peers run one el_rel_t per context; it carries both directions.
+ * Call el_rel_poll() periodically (every few ms, or after the delay it
+ * returns) to drive retransmits and delayed ACKs.
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#ifndef ETHERLINK_RELIABLE_H
+#define ETHERLINK_RELIABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "etherlink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EL_REL_HDR_SIZE         3       // seq + msg_id
+#define EL_REL_MAX_PAYLOAD      (EL_MAX_PAYLOAD - EL_REL_HDR_SIZE)
+#define EL_REL_WINDOW_MAX       32      // Limited by the ACK bitmap
+
+/**
+ * Millisecond clock (e.g. esp_log_timestamp)
+ */
+typedef uint32_t (*el_rel_clock_t)(void);
+
+/**
+ * Hook for locking and window-space signalling
+ * @param user hook_user from el_rel_config_t
+ */
+typedef void (*el_rel_hook_t)(void *user);
+
+/**
+ * One frame buffer; provide arrays of these as tx and rx slots
+ */
+typedef struct {
+    uint8_t frame[EL_MAX_PAYLOAD];  // [seq lo] [seq hi] [msg_id] [payload]
+    uint8_t len;                    // Bytes used in frame
+    bool used;
+    bool acked;
+    uint8_t tries;                  // Transmissions so far
+    uint32_t sent_ms;               // Time of the last transmission
+} el_rel_slot_t;
+
+/**
+ * Configuration for el_rel_init
+ *
+ * Zero timing fields pick the defaults in brackets.
+ */
+typedef struct {
+    el_ctx_t *ctx;                  // Required: context to send and receive on
+    el_rel_clock_t now_ms;          // Required: millisecond clock
+
+    el_rel_slot_t *tx_slots;        // In-flight frames (NULL = receive only)
+    uint8_t tx_window;              // Number of tx_slots (1..EL_REL_WINDOW_MAX)
+    el_rel_slot_t *rx_slots;        // Reorder buffer (NULL = in-order frames only)
+    uint8_t rx_window;              // Number of rx_slots (0..EL_REL_WINDOW_MAX)
+
+    el_handler_t on_message;        // Receives messages in sequence
+    void *user;                     // Passed to on_message
+
+    uint16_t rto_initial_ms;        // RTO before the first RTT sample [250]
+    uint16_t rto_min_ms;            // [20]
+    uint16_t rto_max_ms;            // [2000]
+    uint8_t max_retries;            // Retransmits per frame before failing [8]
+    uint8_t ack_every;              // ACK after this many in-order frames [4]
+    uint16_t ack_delay_ms;          // Or after this long, from el_rel_poll [5]
+
+    // Optional, for use from several tasks: lock/unlock guard the channel
+    // state (RX runs in the transport's task, sends in yours). notify is
+    // called when ACKs free tx slots; wait is called by el_rel_send while
+    // the window is full (without it, el_rel_send fails instead).
+    el_rel_hook_t lock;
+    el_rel_hook_t unlock;
+    el_rel_hook_t notify;
+    el_rel_hook_t wait;
+    void *hook_user;
+} el_rel_config_t;
+
+/**
+ * Reliable channel, one per context
+ */
+struct el_rel_s {
+    el_rel_config_t cfg;
+
+    // Transmit state
+    uint16_t tx_base;               // Oldest unacknowledged seq
+    uint16_t tx_next;               // Next seq to assign
+    uint32_t srtt_ms;               // Smoothed RTT (0 = no sample yet)
+    uint32_t rttvar_ms;
+    uint32_t rto_ms;                // Current retransmit timeout
+    bool failed;                    // A frame ran out of retries
+
+    // Receive state
+    uint16_t rx_next;               // Next seq to deliver
+    uint32_t rx_held;               // Bit i = seq rx_next + 1 + i is in rx_slots
+    uint8_t ack_pending;            // In-order frames not yet acknowledged
+    uint32_t ack_since_ms;
+
+    // Statistics
+    uint32_t tx_frames;             // New frames sent
+    uint32_t tx_retransmits;        // Retransmissions (timeout or NACK)
+    uint32_t tx_timeouts;           // RTO expiries
+    uint32_t tx_window_full;        // el_rel_send calls refused for lack of slots
+    uint32_t rx_delivered;          // Messages passed to on_message
+    uint32_t rx_duplicates;         // Frames received again
+    uint32_t rx_out_of_order;       // Frames held for reordering
+    uint32_t rx_dropped;            // Frames beyond the reorder window
+    uint32_t acks_sent;
+    uint32_t acks_received;
+};
+
+/**
+ * Initialize a reliable channel and attach it to cfg->ctx
+ *
+ * From then on EL_MSG_REL_DATA and EL_MSG_REL_ACK frames received on the
+ * context are consumed by the channel instead of being dispatched.
+ *
+ * @param rel Channel to initialize
+ * @param config Configuration (copied)
+ * @return true on success, false on a missing ctx/clock or bad window size
+ */
+bool el_rel_init(el_rel_t *rel, const el_rel_config_t *config);
+
+/**
+ * Queue a message for reliable delivery
+ *
+ * The frame is sent at once and kept until acknowledged. A frame the
+ * transport refuses (e.g. a full TX ring) is simply retransmitted later.
+ *
+ * @param rel Channel
+ * @param msg_id Message type identifier, as seen by the peer's on_message
+ * @param payload Payload data
+ * @param len Payload length (up to EL_REL_MAX_PAYLOAD)
+ * @return true if queued, false if the window is full (and no wait hook
+ *         is set), the channel failed or the arguments are invalid
+ */
+bool el_rel_send(el_rel_t *rel, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * Run retransmit timers and send delayed ACKs
+ * @param rel Channel
+ * @return Milliseconds until the next timer is due (ack_delay_ms or the
+ *         RTO when idle), a good upper bound for sleeping
+ */
+uint32_t el_rel_poll(el_rel_t *rel);
+
+/**
+ * Check whether every sent frame has been acknowledged
+ * @param rel Channel
+ * @return true if nothing is in flight
+ */
+bool el_rel_idle(const el_rel_t *rel);
+
+/**
+ * Drop all state and restart both directions at sequence 0
+ *
+ * Use after a reconnect or failure; both peers must reset together.
+ * @param rel Channel
+ */
+void el_rel_reset(el_rel_t *rel);
+
+/**
+ * Handle a received EL_MSG_REL_* frame (called by the parser)
+ * @param rel Channel
+ * @param msg_id EL_MSG_REL_DATA or EL_MSG_REL_ACK
+ * @param payload Frame payload
+ * @param len Payload length
+ */
+void el_rel_rx(el_rel_t *rel, uint8_t msg_id, const uint8_t *payload, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERLINK_RELIABLE_H
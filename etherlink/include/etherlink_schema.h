@@ -0,0 +1,164 @@
+/**
+ * Etherlink Message Schema
+ *
+ * Declare every message once in an X-macro table and generate typed send
+ * functions, typed receive callbacks and a compile-time ID collision check
+ * from it. tools/el_schema_gen.py reads the same table to generate a
+ * host-side Python decoder, so both ends stay in sync.
+ *
+ *     // my_messages.h
+ *     typedef struct {
+ *         uint32_t timestamp;
+ *         int16_t temperature;
+ *         int16_t humidity;
+ *     } my_sensor_t;
+ *
+ *     typedef struct {
+ *         uint8_t led;
+ *         uint8_t on;
+ *     } my_led_t;
+ *
+ *     #define MY_MESSAGES(X) \
+ *         X(0x10, sensor,  my_sensor_t, TX) \
+ *         X(0x80, set_led, my_led_t,    RX)
+ *
+ *     EL_SCHEMA_DECLARE(my, MY_MESSAGES)
+ *
+ *     // my_messages.c (exactly one translation unit)
+ *     EL_SCHEMA_DEFINE(my, MY_MESSAGES)
+ *
+ * Each entry is X(id, name, type, dir) with dir one of:
+ *   TX   - device -> host: generates bool el_send_<name>(ctx, const type *)
+ *   RX   - host -> device: you implement void on_<name>(ctx, const type *)
+ *   BOTH - both of the above
+ *
+ * my_register(ctx) installs every RX handler in ctx's handler table (see
+ * el_register_handler), which el_config_t.handlers must provide. A frame
+ * whose length differs from sizeof(type) is counted in rx_bad_length and
+ * never reaches on_<name>.
+ *
+ * Payload types are sent as their in-memory image (little-endian). Plain
+ * structs laid out without padding (largest fields first) give aligned
+ * field access in on_<name>: the payload is passed in place when it happens
+ * to be suitably aligned and copied to an aligned local otherwise. Structs
+ * declared with EL_PACKED_STRUCT also work, but every field access is then
+ * an unaligned load.
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#ifndef ETHERLINK_SCHEMA_H
+#define ETHERLINK_SCHEMA_H
+
+#include <stdint.h>
+#include <string.h>
+#include "etherlink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+#define EL_SCHEMA_STATIC_ASSERT     static_assert
+#define EL_SCHEMA_ALIGNOF           alignof
+#else
+#define EL_SCHEMA_STATIC_ASSERT     _Static_assert
+#define EL_SCHEMA_ALIGNOF           _Alignof
+#endif
+
+// Direction selectors: EL_SCHEMA_IF_<side>_<dir>(...) keeps its arguments
+// when <dir> includes <side>
+#define EL_SCHEMA_IF_TX_TX(...)     __VA_ARGS__
+#define EL_SCHEMA_IF_TX_RX(...)
+#define EL_SCHEMA_IF_TX_BOTH(...)   __VA_ARGS__
+#define EL_SCHEMA_IF_RX_TX(...)
+#define EL_SCHEMA_IF_RX_RX(...)     __VA_ARGS__
+#define EL_SCHEMA_IF_RX_BOTH(...)   __VA_ARGS__
+
+/*******************************************************************************
+ * Declarations (header)
+ ******************************************************************************/
+
+#define EL_SCHEMA_ID_ENUM(id, name, type, dir) \
+    EL_MSG_ID_##name = (id),
+
+#define EL_SCHEMA_SIZE_CHECK(id, name, type, dir) \
+    EL_SCHEMA_STATIC_ASSERT(sizeof(type) <= EL_MAX_PAYLOAD, \
+                            #type " exceeds EL_MAX_PAYLOAD"); \
+    EL_SCHEMA_STATIC_ASSERT((id) <= 0xFF, #name ": id out of range");
+
+#define EL_SCHEMA_SEND_FN(id, name, type, dir) \
+    EL_SCHEMA_IF_TX_##dir( \
+    static inline bool el_send_##name(el_ctx_t *ctx, const type *msg) { \
+        return el_send(ctx, (id), msg, sizeof(type)); \
+    })
+
+#define EL_SCHEMA_RX_PROTO(id, name, type, dir) \
+    EL_SCHEMA_IF_RX_##dir( \
+    void on_##name(el_ctx_t *ctx, const type *msg);)
+
+// Duplicate IDs become duplicate case labels, which fail to compile
+#define EL_SCHEMA_ID_CASE(id, name, type, dir) \
+    case (id):
+
+/**
+ * Declare a schema: message ID enum (EL_MSG_ID_<name>), typed senders,
+ * on_<name> prototypes and <schema>_register()
+ * @param schema Prefix for the generated register function
+ * @param LIST X-macro table
+ */
+#define EL_SCHEMA_DECLARE(schema, LIST) \
+    enum { LIST(EL_SCHEMA_ID_ENUM) }; \
+    LIST(EL_SCHEMA_SIZE_CHECK) \
+    LIST(EL_SCHEMA_SEND_FN) \
+    LIST(EL_SCHEMA_RX_PROTO) \
+    static inline void schema##_schema_id_check(uint8_t id) { \
+        switch (id) { LIST(EL_SCHEMA_ID_CASE) break; } \
+    } \
+    bool schema##_register(el_ctx_t *ctx);
+
+/*******************************************************************************
+ * Definitions (one translation unit)
+ ******************************************************************************/
+
+#define EL_SCHEMA_RX_TRAMPOLINE(id, name, type, dir) \
+    EL_SCHEMA_IF_RX_##dir( \
+    static void el_schema_rx_##name(void *user, uint8_t msg_id, \
+                                    const void *payload, uint8_t len) { \
+        el_ctx_t *ctx = (el_ctx_t *)user; \
+        (void)msg_id; \
+        if (len != sizeof(type)) { \
+            ctx->rx_bad_length++; \
+            return; \
+        } \
+        if (((uintptr_t)payload % EL_SCHEMA_ALIGNOF(type)) == 0) { \
+            on_##name(ctx, (const type *)payload); \
+        } else { \
+            type msg; \
+            memcpy(&msg, payload, sizeof(type)); \
+            on_##name(ctx, &msg); \
+        } \
+    })
+
+#define EL_SCHEMA_RX_REGISTER(id, name, type, dir) \
+    EL_SCHEMA_IF_RX_##dir( \
+    ok &= el_register_handler(ctx, (id), el_schema_rx_##name, ctx, sizeof(type));)
+
+/**
+ * Define a schema's receive trampolines and <schema>_register()
+ * @param schema Prefix given to EL_SCHEMA_DECLARE
+ * @param LIST X-macro table
+ */
+#define EL_SCHEMA_DEFINE(schema, LIST) \
+    LIST(EL_SCHEMA_RX_TRAMPOLINE) \
+    bool schema##_register(el_ctx_t *ctx) { \
+        bool ok = true; \
+        LIST(EL_SCHEMA_RX_REGISTER) \
+        return ok; \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERLINK_SCHEMA_H
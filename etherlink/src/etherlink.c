@@ -5,8 +5,47 @@
  */
 
 #include "etherlink.h"
+#include "etherlink_codec.h"
+#include "etherlink_reliable.h"
 #include <string.h>
 
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#if EL_TRACE
+#include "esp_cpu.h"
+#endif
+#endif
+
+/*******************************************************************************
+ * CRC-8 Kernel Selection
+ * Pick with Kconfig (Etherlink -> CRC-8 implementation) or -DEL_CRC8_IMPL=...
+ * (EL_CRC8_TABLE etc., see etherlink.h). EL_CRC8_BENCH builds all of them.
+ ******************************************************************************/
+
+#ifndef EL_CRC8_IMPL
+#if defined(CONFIG_ETHERLINK_CRC8_SLICE4)
+#define EL_CRC8_IMPL        EL_CRC8_SLICE4
+#elif defined(CONFIG_ETHERLINK_CRC8_SLICE8)
+#define EL_CRC8_IMPL        EL_CRC8_SLICE8
+#elif defined(CONFIG_ETHERLINK_CRC8_BITWISE)
+#define EL_CRC8_IMPL        EL_CRC8_BITWISE
+#else
+#define EL_CRC8_IMPL        EL_CRC8_TABLE
+#endif
+#endif
+
+// Kernels compiled into this build
+#define CRC8_HAS(impl)      (EL_CRC8_IMPL == (impl) || EL_CRC8_BENCH)
+
+// Rows of crc8_slice: slicing-by-8 needs 7, slicing-by-4 the first 3
+#if CRC8_HAS(EL_CRC8_SLICE8)
+#define CRC8_SLICE_ROWS     7
+#elif CRC8_HAS(EL_CRC8_SLICE4)
+#define CRC8_SLICE_ROWS     3
+#endif
+
+#if EL_CRC8_IMPL != EL_CRC8_BITWISE || EL_CRC8_BENCH
+
 /*******************************************************************************
  * CRC-8/CCITT Lookup Table
  * Polynomial: 0x07, Init: 0x00
@@ -47,140 +86,1787 @@ static const uint8_t crc8_table[256] = {
     0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
 };
 
+#endif // EL_CRC8_IMPL != EL_CRC8_BITWISE || EL_CRC8_BENCH
+
+#ifdef CRC8_SLICE_ROWS
+
+/*******************************************************************************
+ * CRC-8 Slicing Tables
+ * crc8_slice[k - 1][x] is the CRC of byte x followed by k zero bytes, which
+ * lets the word-wide kernels fold 4 or 8 input bytes per step.
+ ******************************************************************************/
+
+static const uint8_t crc8_slice[CRC8_SLICE_ROWS][256] = {
+    {
+        0x00, 0x15, 0x2A, 0x3F, 0x54, 0x41, 0x7E, 0x6B,
+        0xA8, 0xBD, 0x82, 0x97, 0xFC, 0xE9, 0xD6, 0xC3,
+        0x57, 0x42, 0x7D, 0x68, 0x03, 0x16, 0x29, 0x3C,
+        0xFF, 0xEA, 0xD5, 0xC0, 0xAB, 0xBE, 0x81, 0x94,
+        0xAE, 0xBB, 0x84, 0x91, 0xFA, 0xEF, 0xD0, 0xC5,
+        0x06, 0x13, 0x2C, 0x39, 0x52, 0x47, 0x78, 0x6D,
+        0xF9, 0xEC, 0xD3, 0xC6, 0xAD, 0xB8, 0x87, 0x92,
+        0x51, 0x44, 0x7B, 0x6E, 0x05, 0x10, 0x2F, 0x3A,
+        0x5B, 0x4E, 0x71, 0x64, 0x0F, 0x1A, 0x25, 0x30,
+        0xF3, 0xE6, 0xD9, 0xCC, 0xA7, 0xB2, 0x8D, 0x98,
+        0x0C, 0x19, 0x26, 0x33, 0x58, 0x4D, 0x72, 0x67,
+        0xA4, 0xB1, 0x8E, 0x9B, 0xF0, 0xE5, 0xDA, 0xCF,
+        0xF5, 0xE0, 0xDF, 0xCA, 0xA1, 0xB4, 0x8B, 0x9E,
+        0x5D, 0x48, 0x77, 0x62, 0x09, 0x1C, 0x23, 0x36,
+        0xA2, 0xB7, 0x88, 0x9D, 0xF6, 0xE3, 0xDC, 0xC9,
+        0x0A, 0x1F, 0x20, 0x35, 0x5E, 0x4B, 0x74, 0x61,
+        0xB6, 0xA3, 0x9C, 0x89, 0xE2, 0xF7, 0xC8, 0xDD,
+        0x1E, 0x0B, 0x34, 0x21, 0x4A, 0x5F, 0x60, 0x75,
+        0xE1, 0xF4, 0xCB, 0xDE, 0xB5, 0xA0, 0x9F, 0x8A,
+        0x49, 0x5C, 0x63, 0x76, 0x1D, 0x08, 0x37, 0x22,
+        0x18, 0x0D, 0x32, 0x27, 0x4C, 0x59, 0x66, 0x73,
+        0xB0, 0xA5, 0x9A, 0x8F, 0xE4, 0xF1, 0xCE, 0xDB,
+        0x4F, 0x5A, 0x65, 0x70, 0x1B, 0x0E, 0x31, 0x24,
+        0xE7, 0xF2, 0xCD, 0xD8, 0xB3, 0xA6, 0x99, 0x8C,
+        0xED, 0xF8, 0xC7, 0xD2, 0xB9, 0xAC, 0x93, 0x86,
+        0x45, 0x50, 0x6F, 0x7A, 0x11, 0x04, 0x3B, 0x2E,
+        0xBA, 0xAF, 0x90, 0x85, 0xEE, 0xFB, 0xC4, 0xD1,
+        0x12, 0x07, 0x38, 0x2D, 0x46, 0x53, 0x6C, 0x79,
+        0x43, 0x56, 0x69, 0x7C, 0x17, 0x02, 0x3D, 0x28,
+        0xEB, 0xFE, 0xC1, 0xD4, 0xBF, 0xAA, 0x95, 0x80,
+        0x14, 0x01, 0x3E, 0x2B, 0x40, 0x55, 0x6A, 0x7F,
+        0xBC, 0xA9, 0x96, 0x83, 0xE8, 0xFD, 0xC2, 0xD7,
+    },
+    {
+        0x00, 0x6B, 0xD6, 0xBD, 0xAB, 0xC0, 0x7D, 0x16,
+        0x51, 0x3A, 0x87, 0xEC, 0xFA, 0x91, 0x2C, 0x47,
+        0xA2, 0xC9, 0x74, 0x1F, 0x09, 0x62, 0xDF, 0xB4,
+        0xF3, 0x98, 0x25, 0x4E, 0x58, 0x33, 0x8E, 0xE5,
+        0x43, 0x28, 0x95, 0xFE, 0xE8, 0x83, 0x3E, 0x55,
+        0x12, 0x79, 0xC4, 0xAF, 0xB9, 0xD2, 0x6F, 0x04,
+        0xE1, 0x8A, 0x37, 0x5C, 0x4A, 0x21, 0x9C, 0xF7,
+        0xB0, 0xDB, 0x66, 0x0D, 0x1B, 0x70, 0xCD, 0xA6,
+        0x86, 0xED, 0x50, 0x3B, 0x2D, 0x46, 0xFB, 0x90,
+        0xD7, 0xBC, 0x01, 0x6A, 0x7C, 0x17, 0xAA, 0xC1,
+        0x24, 0x4F, 0xF2, 0x99, 0x8F, 0xE4, 0x59, 0x32,
+        0x75, 0x1E, 0xA3, 0xC8, 0xDE, 0xB5, 0x08, 0x63,
+        0xC5, 0xAE, 0x13, 0x78, 0x6E, 0x05, 0xB8, 0xD3,
+        0x94, 0xFF, 0x42, 0x29, 0x3F, 0x54, 0xE9, 0x82,
+        0x67, 0x0C, 0xB1, 0xDA, 0xCC, 0xA7, 0x1A, 0x71,
+        0x36, 0x5D, 0xE0, 0x8B, 0x9D, 0xF6, 0x4B, 0x20,
+        0x0B, 0x60, 0xDD, 0xB6, 0xA0, 0xCB, 0x76, 0x1D,
+        0x5A, 0x31, 0x8C, 0xE7, 0xF1, 0x9A, 0x27, 0x4C,
+        0xA9, 0xC2, 0x7F, 0x14, 0x02, 0x69, 0xD4, 0xBF,
+        0xF8, 0x93, 0x2E, 0x45, 0x53, 0x38, 0x85, 0xEE,
+        0x48, 0x23, 0x9E, 0xF5, 0xE3, 0x88, 0x35, 0x5E,
+        0x19, 0x72, 0xCF, 0xA4, 0xB2, 0xD9, 0x64, 0x0F,
+        0xEA, 0x81, 0x3C, 0x57, 0x41, 0x2A, 0x97, 0xFC,
+        0xBB, 0xD0, 0x6D, 0x06, 0x10, 0x7B, 0xC6, 0xAD,
+        0x8D, 0xE6, 0x5B, 0x30, 0x26, 0x4D, 0xF0, 0x9B,
+        0xDC, 0xB7, 0x0A, 0x61, 0x77, 0x1C, 0xA1, 0xCA,
+        0x2F, 0x44, 0xF9, 0x92, 0x84, 0xEF, 0x52, 0x39,
+        0x7E, 0x15, 0xA8, 0xC3, 0xD5, 0xBE, 0x03, 0x68,
+        0xCE, 0xA5, 0x18, 0x73, 0x65, 0x0E, 0xB3, 0xD8,
+        0x9F, 0xF4, 0x49, 0x22, 0x34, 0x5F, 0xE2, 0x89,
+        0x6C, 0x07, 0xBA, 0xD1, 0xC7, 0xAC, 0x11, 0x7A,
+        0x3D, 0x56, 0xEB, 0x80, 0x96, 0xFD, 0x40, 0x2B,
+    },
+    {
+        0x00, 0x16, 0x2C, 0x3A, 0x58, 0x4E, 0x74, 0x62,
+        0xB0, 0xA6, 0x9C, 0x8A, 0xE8, 0xFE, 0xC4, 0xD2,
+        0x67, 0x71, 0x4B, 0x5D, 0x3F, 0x29, 0x13, 0x05,
+        0xD7, 0xC1, 0xFB, 0xED, 0x8F, 0x99, 0xA3, 0xB5,
+        0xCE, 0xD8, 0xE2, 0xF4, 0x96, 0x80, 0xBA, 0xAC,
+        0x7E, 0x68, 0x52, 0x44, 0x26, 0x30, 0x0A, 0x1C,
+        0xA9, 0xBF, 0x85, 0x93, 0xF1, 0xE7, 0xDD, 0xCB,
+        0x19, 0x0F, 0x35, 0x23, 0x41, 0x57, 0x6D, 0x7B,
+        0x9B, 0x8D, 0xB7, 0xA1, 0xC3, 0xD5, 0xEF, 0xF9,
+        0x2B, 0x3D, 0x07, 0x11, 0x73, 0x65, 0x5F, 0x49,
+        0xFC, 0xEA, 0xD0, 0xC6, 0xA4, 0xB2, 0x88, 0x9E,
+        0x4C, 0x5A, 0x60, 0x76, 0x14, 0x02, 0x38, 0x2E,
+        0x55, 0x43, 0x79, 0x6F, 0x0D, 0x1B, 0x21, 0x37,
+        0xE5, 0xF3, 0xC9, 0xDF, 0xBD, 0xAB, 0x91, 0x87,
+        0x32, 0x24, 0x1E, 0x08, 0x6A, 0x7C, 0x46, 0x50,
+        0x82, 0x94, 0xAE, 0xB8, 0xDA, 0xCC, 0xF6, 0xE0,
+        0x31, 0x27, 0x1D, 0x0B, 0x69, 0x7F, 0x45, 0x53,
+        0x81, 0x97, 0xAD, 0xBB, 0xD9, 0xCF, 0xF5, 0xE3,
+        0x56, 0x40, 0x7A, 0x6C, 0x0E, 0x18, 0x22, 0x34,
+        0xE6, 0xF0, 0xCA, 0xDC, 0xBE, 0xA8, 0x92, 0x84,
+        0xFF, 0xE9, 0xD3, 0xC5, 0xA7, 0xB1, 0x8B, 0x9D,
+        0x4F, 0x59, 0x63, 0x75, 0x17, 0x01, 0x3B, 0x2D,
+        0x98, 0x8E, 0xB4, 0xA2, 0xC0, 0xD6, 0xEC, 0xFA,
+        0x28, 0x3E, 0x04, 0x12, 0x70, 0x66, 0x5C, 0x4A,
+        0xAA, 0xBC, 0x86, 0x90, 0xF2, 0xE4, 0xDE, 0xC8,
+        0x1A, 0x0C, 0x36, 0x20, 0x42, 0x54, 0x6E, 0x78,
+        0xCD, 0xDB, 0xE1, 0xF7, 0x95, 0x83, 0xB9, 0xAF,
+        0x7D, 0x6B, 0x51, 0x47, 0x25, 0x33, 0x09, 0x1F,
+        0x64, 0x72, 0x48, 0x5E, 0x3C, 0x2A, 0x10, 0x06,
+        0xD4, 0xC2, 0xF8, 0xEE, 0x8C, 0x9A, 0xA0, 0xB6,
+        0x03, 0x15, 0x2F, 0x39, 0x5B, 0x4D, 0x77, 0x61,
+        0xB3, 0xA5, 0x9F, 0x89, 0xEB, 0xFD, 0xC7, 0xD1,
+    },
+#if CRC8_SLICE_ROWS > 3
+    {
+        0x00, 0x62, 0xC4, 0xA6, 0x8F, 0xED, 0x4B, 0x29,
+        0x19, 0x7B, 0xDD, 0xBF, 0x96, 0xF4, 0x52, 0x30,
+        0x32, 0x50, 0xF6, 0x94, 0xBD, 0xDF, 0x79, 0x1B,
+        0x2B, 0x49, 0xEF, 0x8D, 0xA4, 0xC6, 0x60, 0x02,
+        0x64, 0x06, 0xA0, 0xC2, 0xEB, 0x89, 0x2F, 0x4D,
+        0x7D, 0x1F, 0xB9, 0xDB, 0xF2, 0x90, 0x36, 0x54,
+        0x56, 0x34, 0x92, 0xF0, 0xD9, 0xBB, 0x1D, 0x7F,
+        0x4F, 0x2D, 0x8B, 0xE9, 0xC0, 0xA2, 0x04, 0x66,
+        0xC8, 0xAA, 0x0C, 0x6E, 0x47, 0x25, 0x83, 0xE1,
+        0xD1, 0xB3, 0x15, 0x77, 0x5E, 0x3C, 0x9A, 0xF8,
+        0xFA, 0x98, 0x3E, 0x5C, 0x75, 0x17, 0xB1, 0xD3,
+        0xE3, 0x81, 0x27, 0x45, 0x6C, 0x0E, 0xA8, 0xCA,
+        0xAC, 0xCE, 0x68, 0x0A, 0x23, 0x41, 0xE7, 0x85,
+        0xB5, 0xD7, 0x71, 0x13, 0x3A, 0x58, 0xFE, 0x9C,
+        0x9E, 0xFC, 0x5A, 0x38, 0x11, 0x73, 0xD5, 0xB7,
+        0x87, 0xE5, 0x43, 0x21, 0x08, 0x6A, 0xCC, 0xAE,
+        0x97, 0xF5, 0x53, 0x31, 0x18, 0x7A, 0xDC, 0xBE,
+        0x8E, 0xEC, 0x4A, 0x28, 0x01, 0x63, 0xC5, 0xA7,
+        0xA5, 0xC7, 0x61, 0x03, 0x2A, 0x48, 0xEE, 0x8C,
+        0xBC, 0xDE, 0x78, 0x1A, 0x33, 0x51, 0xF7, 0x95,
+        0xF3, 0x91, 0x37, 0x55, 0x7C, 0x1E, 0xB8, 0xDA,
+        0xEA, 0x88, 0x2E, 0x4C, 0x65, 0x07, 0xA1, 0xC3,
+        0xC1, 0xA3, 0x05, 0x67, 0x4E, 0x2C, 0x8A, 0xE8,
+        0xD8, 0xBA, 0x1C, 0x7E, 0x57, 0x35, 0x93, 0xF1,
+        0x5F, 0x3D, 0x9B, 0xF9, 0xD0, 0xB2, 0x14, 0x76,
+        0x46, 0x24, 0x82, 0xE0, 0xC9, 0xAB, 0x0D, 0x6F,
+        0x6D, 0x0F, 0xA9, 0xCB, 0xE2, 0x80, 0x26, 0x44,
+        0x74, 0x16, 0xB0, 0xD2, 0xFB, 0x99, 0x3F, 0x5D,
+        0x3B, 0x59, 0xFF, 0x9D, 0xB4, 0xD6, 0x70, 0x12,
+        0x22, 0x40, 0xE6, 0x84, 0xAD, 0xCF, 0x69, 0x0B,
+        0x09, 0x6B, 0xCD, 0xAF, 0x86, 0xE4, 0x42, 0x20,
+        0x10, 0x72, 0xD4, 0xB6, 0x9F, 0xFD, 0x5B, 0x39,
+    },
+    {
+        0x00, 0x29, 0x52, 0x7B, 0xA4, 0x8D, 0xF6, 0xDF,
+        0x4F, 0x66, 0x1D, 0x34, 0xEB, 0xC2, 0xB9, 0x90,
+        0x9E, 0xB7, 0xCC, 0xE5, 0x3A, 0x13, 0x68, 0x41,
+        0xD1, 0xF8, 0x83, 0xAA, 0x75, 0x5C, 0x27, 0x0E,
+        0x3B, 0x12, 0x69, 0x40, 0x9F, 0xB6, 0xCD, 0xE4,
+        0x74, 0x5D, 0x26, 0x0F, 0xD0, 0xF9, 0x82, 0xAB,
+        0xA5, 0x8C, 0xF7, 0xDE, 0x01, 0x28, 0x53, 0x7A,
+        0xEA, 0xC3, 0xB8, 0x91, 0x4E, 0x67, 0x1C, 0x35,
+        0x76, 0x5F, 0x24, 0x0D, 0xD2, 0xFB, 0x80, 0xA9,
+        0x39, 0x10, 0x6B, 0x42, 0x9D, 0xB4, 0xCF, 0xE6,
+        0xE8, 0xC1, 0xBA, 0x93, 0x4C, 0x65, 0x1E, 0x37,
+        0xA7, 0x8E, 0xF5, 0xDC, 0x03, 0x2A, 0x51, 0x78,
+        0x4D, 0x64, 0x1F, 0x36, 0xE9, 0xC0, 0xBB, 0x92,
+        0x02, 0x2B, 0x50, 0x79, 0xA6, 0x8F, 0xF4, 0xDD,
+        0xD3, 0xFA, 0x81, 0xA8, 0x77, 0x5E, 0x25, 0x0C,
+        0x9C, 0xB5, 0xCE, 0xE7, 0x38, 0x11, 0x6A, 0x43,
+        0xEC, 0xC5, 0xBE, 0x97, 0x48, 0x61, 0x1A, 0x33,
+        0xA3, 0x8A, 0xF1, 0xD8, 0x07, 0x2E, 0x55, 0x7C,
+        0x72, 0x5B, 0x20, 0x09, 0xD6, 0xFF, 0x84, 0xAD,
+        0x3D, 0x14, 0x6F, 0x46, 0x99, 0xB0, 0xCB, 0xE2,
+        0xD7, 0xFE, 0x85, 0xAC, 0x73, 0x5A, 0x21, 0x08,
+        0x98, 0xB1, 0xCA, 0xE3, 0x3C, 0x15, 0x6E, 0x47,
+        0x49, 0x60, 0x1B, 0x32, 0xED, 0xC4, 0xBF, 0x96,
+        0x06, 0x2F, 0x54, 0x7D, 0xA2, 0x8B, 0xF0, 0xD9,
+        0x9A, 0xB3, 0xC8, 0xE1, 0x3E, 0x17, 0x6C, 0x45,
+        0xD5, 0xFC, 0x87, 0xAE, 0x71, 0x58, 0x23, 0x0A,
+        0x04, 0x2D, 0x56, 0x7F, 0xA0, 0x89, 0xF2, 0xDB,
+        0x4B, 0x62, 0x19, 0x30, 0xEF, 0xC6, 0xBD, 0x94,
+        0xA1, 0x88, 0xF3, 0xDA, 0x05, 0x2C, 0x57, 0x7E,
+        0xEE, 0xC7, 0xBC, 0x95, 0x4A, 0x63, 0x18, 0x31,
+        0x3F, 0x16, 0x6D, 0x44, 0x9B, 0xB2, 0xC9, 0xE0,
+        0x70, 0x59, 0x22, 0x0B, 0xD4, 0xFD, 0x86, 0xAF,
+    },
+    {
+        0x00, 0xDF, 0xB9, 0x66, 0x75, 0xAA, 0xCC, 0x13,
+        0xEA, 0x35, 0x53, 0x8C, 0x9F, 0x40, 0x26, 0xF9,
+        0xD3, 0x0C, 0x6A, 0xB5, 0xA6, 0x79, 0x1F, 0xC0,
+        0x39, 0xE6, 0x80, 0x5F, 0x4C, 0x93, 0xF5, 0x2A,
+        0xA1, 0x7E, 0x18, 0xC7, 0xD4, 0x0B, 0x6D, 0xB2,
+        0x4B, 0x94, 0xF2, 0x2D, 0x3E, 0xE1, 0x87, 0x58,
+        0x72, 0xAD, 0xCB, 0x14, 0x07, 0xD8, 0xBE, 0x61,
+        0x98, 0x47, 0x21, 0xFE, 0xED, 0x32, 0x54, 0x8B,
+        0x45, 0x9A, 0xFC, 0x23, 0x30, 0xEF, 0x89, 0x56,
+        0xAF, 0x70, 0x16, 0xC9, 0xDA, 0x05, 0x63, 0xBC,
+        0x96, 0x49, 0x2F, 0xF0, 0xE3, 0x3C, 0x5A, 0x85,
+        0x7C, 0xA3, 0xC5, 0x1A, 0x09, 0xD6, 0xB0, 0x6F,
+        0xE4, 0x3B, 0x5D, 0x82, 0x91, 0x4E, 0x28, 0xF7,
+        0x0E, 0xD1, 0xB7, 0x68, 0x7B, 0xA4, 0xC2, 0x1D,
+        0x37, 0xE8, 0x8E, 0x51, 0x42, 0x9D, 0xFB, 0x24,
+        0xDD, 0x02, 0x64, 0xBB, 0xA8, 0x77, 0x11, 0xCE,
+        0x8A, 0x55, 0x33, 0xEC, 0xFF, 0x20, 0x46, 0x99,
+        0x60, 0xBF, 0xD9, 0x06, 0x15, 0xCA, 0xAC, 0x73,
+        0x59, 0x86, 0xE0, 0x3F, 0x2C, 0xF3, 0x95, 0x4A,
+        0xB3, 0x6C, 0x0A, 0xD5, 0xC6, 0x19, 0x7F, 0xA0,
+        0x2B, 0xF4, 0x92, 0x4D, 0x5E, 0x81, 0xE7, 0x38,
+        0xC1, 0x1E, 0x78, 0xA7, 0xB4, 0x6B, 0x0D, 0xD2,
+        0xF8, 0x27, 0x41, 0x9E, 0x8D, 0x52, 0x34, 0xEB,
+        0x12, 0xCD, 0xAB, 0x74, 0x67, 0xB8, 0xDE, 0x01,
+        0xCF, 0x10, 0x76, 0xA9, 0xBA, 0x65, 0x03, 0xDC,
+        0x25, 0xFA, 0x9C, 0x43, 0x50, 0x8F, 0xE9, 0x36,
+        0x1C, 0xC3, 0xA5, 0x7A, 0x69, 0xB6, 0xD0, 0x0F,
+        0xF6, 0x29, 0x4F, 0x90, 0x83, 0x5C, 0x3A, 0xE5,
+        0x6E, 0xB1, 0xD7, 0x08, 0x1B, 0xC4, 0xA2, 0x7D,
+        0x84, 0x5B, 0x3D, 0xE2, 0xF1, 0x2E, 0x48, 0x97,
+        0xBD, 0x62, 0x04, 0xDB, 0xC8, 0x17, 0x71, 0xAE,
+        0x57, 0x88, 0xEE, 0x31, 0x22, 0xFD, 0x9B, 0x44,
+    },
+    {
+        0x00, 0x13, 0x26, 0x35, 0x4C, 0x5F, 0x6A, 0x79,
+        0x98, 0x8B, 0xBE, 0xAD, 0xD4, 0xC7, 0xF2, 0xE1,
+        0x37, 0x24, 0x11, 0x02, 0x7B, 0x68, 0x5D, 0x4E,
+        0xAF, 0xBC, 0x89, 0x9A, 0xE3, 0xF0, 0xC5, 0xD6,
+        0x6E, 0x7D, 0x48, 0x5B, 0x22, 0x31, 0x04, 0x17,
+        0xF6, 0xE5, 0xD0, 0xC3, 0xBA, 0xA9, 0x9C, 0x8F,
+        0x59, 0x4A, 0x7F, 0x6C, 0x15, 0x06, 0x33, 0x20,
+        0xC1, 0xD2, 0xE7, 0xF4, 0x8D, 0x9E, 0xAB, 0xB8,
+        0xDC, 0xCF, 0xFA, 0xE9, 0x90, 0x83, 0xB6, 0xA5,
+        0x44, 0x57, 0x62, 0x71, 0x08, 0x1B, 0x2E, 0x3D,
+        0xEB, 0xF8, 0xCD, 0xDE, 0xA7, 0xB4, 0x81, 0x92,
+        0x73, 0x60, 0x55, 0x46, 0x3F, 0x2C, 0x19, 0x0A,
+        0xB2, 0xA1, 0x94, 0x87, 0xFE, 0xED, 0xD8, 0xCB,
+        0x2A, 0x39, 0x0C, 0x1F, 0x66, 0x75, 0x40, 0x53,
+        0x85, 0x96, 0xA3, 0xB0, 0xC9, 0xDA, 0xEF, 0xFC,
+        0x1D, 0x0E, 0x3B, 0x28, 0x51, 0x42, 0x77, 0x64,
+        0xBF, 0xAC, 0x99, 0x8A, 0xF3, 0xE0, 0xD5, 0xC6,
+        0x27, 0x34, 0x01, 0x12, 0x6B, 0x78, 0x4D, 0x5E,
+        0x88, 0x9B, 0xAE, 0xBD, 0xC4, 0xD7, 0xE2, 0xF1,
+        0x10, 0x03, 0x36, 0x25, 0x5C, 0x4F, 0x7A, 0x69,
+        0xD1, 0xC2, 0xF7, 0xE4, 0x9D, 0x8E, 0xBB, 0xA8,
+        0x49, 0x5A, 0x6F, 0x7C, 0x05, 0x16, 0x23, 0x30,
+        0xE6, 0xF5, 0xC0, 0xD3, 0xAA, 0xB9, 0x8C, 0x9F,
+        0x7E, 0x6D, 0x58, 0x4B, 0x32, 0x21, 0x14, 0x07,
+        0x63, 0x70, 0x45, 0x56, 0x2F, 0x3C, 0x09, 0x1A,
+        0xFB, 0xE8, 0xDD, 0xCE, 0xB7, 0xA4, 0x91, 0x82,
+        0x54, 0x47, 0x72, 0x61, 0x18, 0x0B, 0x3E, 0x2D,
+        0xCC, 0xDF, 0xEA, 0xF9, 0x80, 0x93, 0xA6, 0xB5,
+        0x0D, 0x1E, 0x2B, 0x38, 0x41, 0x52, 0x67, 0x74,
+        0x95, 0x86, 0xB3, 0xA0, 0xD9, 0xCA, 0xFF, 0xEC,
+        0x3A, 0x29, 0x1C, 0x0F, 0x76, 0x65, 0x50, 0x43,
+        0xA2, 0xB1, 0x84, 0x97, 0xEE, 0xFD, 0xC8, 0xDB,
+    },
+#endif
+};
+
+#endif // CRC8_SLICE_ROWS
+
+#if EL_CRC8_IMPL != EL_CRC8_BITWISE
+
+/*******************************************************************************
+ * CRC-16/CCITT-FALSE Lookup Table (extended frames)
+ * Polynomial: 0x1021, Init: 0xFFFF, MSB first
+ ******************************************************************************/
+
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+/*******************************************************************************
+ * CRC-32/ISO-HDLC Lookup Table (checked frames)
+ * Polynomial: 0x04C11DB7 reflected (0xEDB88320), Init/XorOut: 0xFFFFFFFF
+ ******************************************************************************/
+
+static const uint32_t crc32_table[256] = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA,
+    0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+    0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+    0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE,
+    0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC,
+    0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+    0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+    0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940,
+    0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116,
+    0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+    0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+    0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A,
+    0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818,
+    0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+    0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+    0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C,
+    0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2,
+    0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+    0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+    0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086,
+    0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4,
+    0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+    0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+    0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8,
+    0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE,
+    0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+    0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+    0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252,
+    0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60,
+    0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+    0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+    0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04,
+    0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A,
+    0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+    0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+    0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E,
+    0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C,
+    0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+    0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+    0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0,
+    0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6,
+    0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+    0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+
+#endif // EL_CRC8_IMPL != EL_CRC8_BITWISE
+
+#define CRC16_INIT          0xFFFF
+#define CRC32_INIT          0xFFFFFFFFu
+#define CRC32_RESIDUE       0xDEBB20E3u     // Register after a valid CRC, sent LSB first
+
 /*******************************************************************************
  * CRC Functions
  ******************************************************************************/
 
-uint8_t el_crc8_update(uint8_t crc, uint8_t byte) {
+#if CRC8_HAS(EL_CRC8_BITWISE)
+static inline uint8_t crc8_byte_bitwise(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+#endif
+
+#if EL_CRC8_IMPL != EL_CRC8_BITWISE || EL_CRC8_BENCH
+static inline uint8_t crc8_byte_table(uint8_t crc, uint8_t byte) {
     return crc8_table[crc ^ byte];
 }
+#endif
 
-uint8_t el_crc8(const uint8_t *data, size_t len) {
-    uint8_t crc = 0x00;
+static inline uint8_t crc8_byte(uint8_t crc, uint8_t byte) {
+#if EL_CRC8_IMPL == EL_CRC8_BITWISE
+    return crc8_byte_bitwise(crc, byte);
+#else
+    return crc8_byte_table(crc, byte);
+#endif
+}
+
+#ifdef CRC8_SLICE_ROWS
+// Load 32 bits in wire order: first byte in bits 0-7, fourth in bits 24-31
+static inline uint32_t load_le32(const uint8_t *p) {
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap32(w);
+#endif
+    return w;
+}
+#endif
+
+#if CRC8_HAS(EL_CRC8_SLICE8)
+static uint8_t crc8_block_slice8(uint8_t crc, const uint8_t *data, size_t len) {
+    while (len >= 8) {
+        uint32_t lo = load_le32(data) ^ crc;
+        uint32_t hi = load_le32(data + 4);
+        crc = crc8_slice[6][lo & 0xFF] ^ crc8_slice[5][(lo >> 8) & 0xFF] ^
+              crc8_slice[4][(lo >> 16) & 0xFF] ^ crc8_slice[3][lo >> 24] ^
+              crc8_slice[2][hi & 0xFF] ^ crc8_slice[1][(hi >> 8) & 0xFF] ^
+              crc8_slice[0][(hi >> 16) & 0xFF] ^ crc8_table[hi >> 24];
+        data += 8;
+        len -= 8;
+    }
+    for (size_t i = 0; i < len; i++) {
+        crc = crc8_byte_table(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+#if CRC8_HAS(EL_CRC8_SLICE4)
+static uint8_t crc8_block_slice4(uint8_t crc, const uint8_t *data, size_t len) {
+    while (len >= 4) {
+        uint32_t w = load_le32(data) ^ crc;
+        crc = crc8_slice[2][w & 0xFF] ^ crc8_slice[1][(w >> 8) & 0xFF] ^
+              crc8_slice[0][(w >> 16) & 0xFF] ^ crc8_table[w >> 24];
+        data += 4;
+        len -= 4;
+    }
+    for (size_t i = 0; i < len; i++) {
+        crc = crc8_byte_table(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+#if CRC8_HAS(EL_CRC8_TABLE)
+static uint8_t crc8_block_table(uint8_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = crc8_byte_table(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+#if CRC8_HAS(EL_CRC8_BITWISE)
+static uint8_t crc8_block_bitwise(uint8_t crc, const uint8_t *data, size_t len) {
     for (size_t i = 0; i < len; i++) {
-        crc = crc8_table[crc ^ data[i]];
+        crc = crc8_byte_bitwise(crc, data[i]);
     }
     return crc;
 }
+#endif
+
+// Continue a running CRC over a block of bytes with the selected kernel
+static inline uint8_t crc8_block(uint8_t crc, const uint8_t *data, size_t len) {
+#if EL_CRC8_IMPL == EL_CRC8_SLICE8
+    return crc8_block_slice8(crc, data, len);
+#elif EL_CRC8_IMPL == EL_CRC8_SLICE4
+    return crc8_block_slice4(crc, data, len);
+#elif EL_CRC8_IMPL == EL_CRC8_BITWISE
+    return crc8_block_bitwise(crc, data, len);
+#else
+    return crc8_block_table(crc, data, len);
+#endif
+}
+
+static inline uint16_t crc16_byte(uint16_t crc, uint8_t byte) {
+#if EL_CRC8_IMPL == EL_CRC8_BITWISE
+    crc ^= (uint16_t)byte << 8;
+    for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+#else
+    return (uint16_t)(crc << 8) ^ crc16_table[(crc >> 8) ^ byte];
+#endif
+}
+
+static uint16_t crc16_block(uint16_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = crc16_byte(crc, data[i]);
+    }
+    return crc;
+}
+
+uint16_t el_crc16(const uint8_t *data, size_t len) {
+    return crc16_block(CRC16_INIT, data, len);
+}
+
+static inline uint32_t crc32_byte(uint32_t crc, uint8_t byte) {
+#if EL_CRC8_IMPL == EL_CRC8_BITWISE
+    crc ^= byte;
+    for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return crc;
+#else
+    return (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
+#endif
+}
+
+static uint32_t crc32_block(uint32_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = crc32_byte(crc, data[i]);
+    }
+    return crc;
+}
+
+uint32_t el_crc32(const uint8_t *data, size_t len) {
+    return ~crc32_block(CRC32_INIT, data, len);
+}
+
+uint8_t el_crc8_update(uint8_t crc, uint8_t byte) {
+    return crc8_byte(crc, byte);
+}
+
+uint8_t el_crc8(const uint8_t *data, size_t len) {
+    return crc8_block(0x00, data, len);
+}
+
+#if EL_CRC8_BENCH
+uint8_t el_crc8_kernel(int impl, const uint8_t *data, size_t len) {
+    switch (impl) {
+        case EL_CRC8_SLICE4:
+            return crc8_block_slice4(0x00, data, len);
+        case EL_CRC8_SLICE8:
+            return crc8_block_slice8(0x00, data, len);
+        case EL_CRC8_BITWISE:
+            return crc8_block_bitwise(0x00, data, len);
+        default:
+            return crc8_block_table(0x00, data, len);
+    }
+}
+#endif
+
+/*******************************************************************************
+ * Trace Hooks
+ * EL_TRACE builds call el_trace_hook; otherwise TRACE() compiles to nothing
+ ******************************************************************************/
+
+#if EL_TRACE
+#ifndef EL_TRACE_CYCLES
+#ifdef ESP_PLATFORM
+#define EL_TRACE_CYCLES()   ((uint32_t)esp_cpu_get_cycle_count())
+#else
+#define EL_TRACE_CYCLES()   0u
+#endif
+#endif
+#define TRACE(event, ctx, info) \
+    el_trace_hook((event), (ctx), (uint32_t)(info), EL_TRACE_CYCLES())
+#else
+#define TRACE(event, ctx, info) ((void)(event), (void)(ctx), (void)(info))
+#endif
 
 /*******************************************************************************
  * Core API Implementation
  ******************************************************************************/
 
 bool el_init(el_ctx_t *ctx, const el_config_t *config) {
-    if (!ctx || !config || !config->on_message || !config->send_bytes) {
+    if (!ctx || !config || (!config->on_message && !config->handlers)) {
+        return false;
+    }
+    if (!config->send_bytes && !config->send_bytesv && !config->tx_ring) {
         return false;
     }
+    // With rescan the buffer also holds the header and CRC of each frame
+    size_t slack = config->rescan ? EL_RESCAN_SLACK : 0;
+    if (config->rx_buffer && (config->rx_buffer_size < EL_MAX_PAYLOAD + slack ||
+                              config->rx_buffer_size > EL_EXT_MAX_PAYLOAD)) {
+        return false;
+    }
+    if ((unsigned)config->frame_crc > EL_CRC_32) {
+        return false;
+    }
+    if (config->tx_ring) {
+        size_t size = config->tx_ring_size;
+        size_t max_frame = config->frame_crc != EL_CRC_8 ? EL_MAX_FRAME
+                                                         : EL_FRAME_OVERHEAD + EL_MAX_PAYLOAD;
+        // Power of two, large enough for the biggest frame
+        if (size < max_frame || size > EL_TX_RING_MAX || (size & (size - 1)) != 0) {
+            return false;
+        }
+        // Only the consumer may move the read position of a shared ring
+        if (config->tx_multi_producer && config->tx_policy == EL_TX_DROP_OLDEST) {
+            return false;
+        }
+    }
 
     memset(ctx, 0, sizeof(el_ctx_t));
     ctx->on_message = config->on_message;
+    ctx->on_message_ext = config->on_message_ext;
+    ctx->ext_frames = config->ext_frames;
+    ctx->auto_pong = config->auto_pong;
+    ctx->auto_stats = config->auto_stats;
+    ctx->rx_id_counts = config->rx_id_counts;
+    ctx->cb_clock = config->cb_clock;
+    ctx->rescan = config->rescan;
+    ctx->rx_crc = config->frame_crc;
+    ctx->rx_buf = config->rx_buffer ? config->rx_buffer : ctx->rx_buffer;
+    ctx->rx_buf_size = config->rx_buffer ? (uint16_t)(config->rx_buffer_size - slack)
+                                         : EL_MAX_PAYLOAD;
     ctx->send_bytes = config->send_bytes;
+    ctx->send_bytesv = config->send_bytesv;
+    ctx->flush = config->flush;
+    ctx->tx_ring.buf = config->tx_ring;
+    ctx->tx_ring.size = config->tx_ring ? (uint32_t)config->tx_ring_size : 0;
+    ctx->tx_ring.policy = config->tx_policy;
+    ctx->tx_ring.multi_producer = config->tx_ring && config->tx_multi_producer;
+    if (ctx->tx_ring.multi_producer) {
+        memset(config->tx_ring, 0, config->tx_ring_size);
+    }
+    ctx->send_user = config->send_user;
+    ctx->handlers = config->handlers;
+    ctx->codec = config->codec;
+    if (ctx->handlers) {
+        memset(ctx->handlers, 0, EL_HANDLER_TABLE_SIZE * sizeof(el_handler_entry_t));
+    }
+    if (ctx->rx_id_counts) {
+        memset(ctx->rx_id_counts, 0, EL_HANDLER_TABLE_SIZE * sizeof(uint32_t));
+    }
     ctx->state = EL_STATE_IDLE;
 
     return true;
 }
 
+void el_bind_transport(el_ctx_t *ctx, el_send_bytesv_t send_bytesv, el_flush_t flush, void *user) {
+    if (ctx) {
+        ctx->send_bytesv = send_bytesv;
+        ctx->flush = flush;
+        ctx->send_user = user;
+    }
+}
+
+bool el_register_handler(el_ctx_t *ctx, uint8_t msg_id, el_handler_t fn,
+                         void *user, uint8_t min_len) {
+    if (!ctx || !ctx->handlers) {
+        return false;
+    }
+
+    el_handler_entry_t *h = &ctx->handlers[msg_id];
+    h->user = user;
+    h->min_len = min_len;
+    h->fn = fn;
+    return true;
+}
+
+void el_set_filter(el_ctx_t *ctx, uint8_t first_id, uint8_t last_id, bool drop) {
+    if (!ctx) {
+        return;
+    }
+
+    for (unsigned id = first_id; id <= last_id; id++) {
+        uint32_t bit = 1u << (id & 31);
+        if (drop) {
+            ctx->rx_filter[id >> 5] |= bit;
+        } else {
+            ctx->rx_filter[id >> 5] &= ~bit;
+        }
+    }
+}
+
+void el_filter_unhandled(el_ctx_t *ctx) {
+    if (!ctx || !ctx->handlers || ctx->on_message) {
+        return;
+    }
+
+    for (unsigned id = 0; id < EL_HANDLER_TABLE_SIZE; id++) {
+        el_set_filter(ctx, id, id, ctx->handlers[id].fn == NULL);
+    }
+}
+
+// EL_CAP_* bits for what this context accepts
+static uint8_t own_caps(const el_ctx_t *ctx) {
+    uint8_t caps = ctx->ext_frames ? EL_CAP_EXT_FRAMES : 0;
+    if (ctx->rx_crc >= EL_CRC_16) {
+        caps |= EL_CAP_CRC16;
+    }
+    if (ctx->rx_crc >= EL_CRC_32) {
+        caps |= EL_CAP_CRC32;
+    }
+    return caps;
+}
+
+static bool send_caps(el_ctx_t *ctx, uint8_t op) {
+    uint8_t msg[3] = { EL_CAPS_TAG, op, own_caps(ctx) };
+    return el_send(ctx, EL_MSG_VERSION, msg, sizeof(msg));
+}
+
+// Capability exchange: send the strongest checked frames both sides accept
+static void caps_rx(el_ctx_t *ctx, uint8_t op, uint8_t peer_caps) {
+    uint8_t common = own_caps(ctx) & peer_caps;
+
+    ctx->peer_caps = peer_caps;
+    ctx->tx_crc = (common & EL_CAP_CRC32) ? EL_CRC_32 :
+                  (common & EL_CAP_CRC16) ? EL_CRC_16 : EL_CRC_8;
+    if (op == EL_CAPS_QUERY) {
+        send_caps(ctx, EL_CAPS_REPLY);
+    }
+}
+
+bool el_negotiate_frames(el_ctx_t *ctx) {
+    if (!ctx || ctx->rx_crc == EL_CRC_8) {
+        return false;
+    }
+    return send_caps(ctx, EL_CAPS_QUERY);
+}
+
+bool el_set_tx_crc(el_ctx_t *ctx, el_crc_t crc) {
+    if (!ctx || (unsigned)crc > EL_CRC_32) {
+        return false;
+    }
+    if (crc != EL_CRC_8 && ctx->tx_ring.buf && ctx->tx_ring.size < EL_MAX_FRAME) {
+        return false;
+    }
+    ctx->tx_crc = crc;
+    return true;
+}
+
+static inline bool rx_filtered(const el_ctx_t *ctx, uint8_t msg_id) {
+    return (ctx->rx_filter[msg_id >> 5] >> (msg_id & 31)) & 1;
+}
+
+// Bracket a user callback: trace it and, with a cb_clock, time it
+static inline uint32_t cb_begin(el_ctx_t *ctx, uint8_t msg_id) {
+    TRACE(EL_TRACE_DISPATCH_BEGIN, ctx, msg_id);
+    return ctx->cb_clock ? ctx->cb_clock() : 0;
+}
+
+static inline void cb_end(el_ctx_t *ctx, uint8_t msg_id, uint32_t start) {
+    if (ctx->cb_clock) {
+        uint32_t dt = ctx->cb_clock() - start;
+        if (dt > ctx->rx_cb_max) {
+            ctx->rx_cb_max = dt;
+        }
+    }
+    TRACE(EL_TRACE_DISPATCH_END, ctx, msg_id);
+}
+
+// Hand a valid frame to its registered handler, or on_message
+static void deliver(el_ctx_t *ctx, uint8_t msg_id, const uint8_t *payload, size_t size) {
+    ctx->rx_frames++;
+    if (ctx->rx_id_counts) {
+        ctx->rx_id_counts[msg_id]++;
+    }
+
+    uint32_t start;
+    if (size > EL_MAX_PAYLOAD) {
+        if (ctx->on_message_ext) {
+            start = cb_begin(ctx, msg_id);
+            ctx->on_message_ext(msg_id, payload, size);
+            cb_end(ctx, msg_id, start);
+        } else {
+            ctx->rx_unhandled++;
+        }
+        return;
+    }
+
+    uint8_t len = (uint8_t)size;
+    if (ctx->reliable && (msg_id == EL_MSG_REL_DATA || msg_id == EL_MSG_REL_ACK)) {
+        el_rel_rx(ctx->reliable, msg_id, payload, len);
+        return;
+    }
+    if (ctx->auto_pong && msg_id == EL_MSG_PING) {
+        el_send(ctx, EL_MSG_PONG, payload, len);
+        return;
+    }
+    if (ctx->auto_stats && msg_id == EL_MSG_STATS && len == 0) {
+        el_send_stats(ctx);
+        return;
+    }
+    if (ctx->rx_crc != EL_CRC_8 && msg_id == EL_MSG_VERSION && len >= 3 &&
+        payload[0] == EL_CAPS_TAG) {
+        caps_rx(ctx, payload[1], payload[2]);
+        return;
+    }
+    if (ctx->codec && !el_codec_rx(ctx->codec, &msg_id, &payload, &len)) {
+        return;
+    }
+
+    if (ctx->handlers) {
+        const el_handler_entry_t *h = &ctx->handlers[msg_id];
+        if (h->fn) {
+            if (len < h->min_len) {
+                ctx->rx_bad_length++;
+            } else {
+                start = cb_begin(ctx, msg_id);
+                h->fn(h->user, msg_id, payload, len);
+                cb_end(ctx, msg_id, start);
+            }
+            return;
+        }
+    }
+
+    if (ctx->on_message) {
+        start = cb_begin(ctx, msg_id);
+        ctx->on_message(msg_id, payload, len);
+        cb_end(ctx, msg_id, start);
+    } else {
+        ctx->rx_unhandled++;
+    }
+}
+
 void el_reset(el_ctx_t *ctx) {
     if (ctx) {
         ctx->state = EL_STATE_IDLE;
         ctx->payload_idx = 0;
         ctx->running_crc = 0;
+        ctx->rx_replay = 0;
     }
 }
 
-void el_process_byte(el_ctx_t *ctx, uint8_t byte) {
-    if (!ctx) return;
+static inline void rx_crc_byte(el_ctx_t *ctx, uint8_t byte) {
+    if (ctx->rx_crc_len == 1) {
+        ctx->running_crc = crc8_byte((uint8_t)ctx->running_crc, byte);
+    } else if (ctx->rx_crc_len == 2) {
+        ctx->running_crc = crc16_byte((uint16_t)ctx->running_crc, byte);
+    } else {
+        ctx->running_crc = crc32_byte(ctx->running_crc, byte);
+    }
+}
+
+static inline void rx_crc_block(el_ctx_t *ctx, const uint8_t *data, size_t len) {
+    if (ctx->rx_crc_len == 1) {
+        ctx->running_crc = crc8_block((uint8_t)ctx->running_crc, data, len);
+    } else if (ctx->rx_crc_len == 2) {
+        ctx->running_crc = crc16_block((uint16_t)ctx->running_crc, data, len);
+    } else {
+        ctx->running_crc = crc32_block(ctx->running_crc, data, len);
+    }
+}
+
+static inline bool is_checked_sync(uint8_t byte) {
+    return byte == EL_SYNC_CRC16 || byte == EL_SYNC_CRC32;
+}
+
+// Whether byte starts a frame this context accepts
+static inline bool rx_is_sync(const el_ctx_t *ctx, uint8_t byte) {
+    return byte == EL_SYNC_BYTE || (byte == EL_SYNC_EXT && ctx->ext_frames) ||
+           (byte == EL_SYNC_CRC16 && ctx->rx_crc >= EL_CRC_16) ||
+           (byte == EL_SYNC_CRC32 && ctx->rx_crc >= EL_CRC_32);
+}
+
+static inline void rx_start_frame(el_ctx_t *ctx, uint8_t sync) {
+    ctx->rx_ext = sync == EL_SYNC_EXT;
+    if (sync == EL_SYNC_BYTE) {
+        ctx->rx_crc_len = 1;
+        ctx->running_crc = 0;
+    } else if (sync == EL_SYNC_CRC32) {
+        ctx->rx_crc_len = 4;
+        ctx->running_crc = CRC32_INIT;
+    } else {
+        ctx->rx_crc_len = 2;
+        ctx->running_crc = CRC16_INIT;
+    }
+    ctx->rx_raw = 0;
+    ctx->state = EL_STATE_GOT_SYNC;
+}
+
+// Rescan mode: keep a header or CRC byte, so that a rejected frame can be
+// parsed again from rx_buf (the payload is stored there anyway)
+static inline void rx_keep(el_ctx_t *ctx, uint8_t byte) {
+    if (ctx->rescan) {
+        ctx->rx_buf[ctx->rx_raw++] = byte;
+    }
+}
+
+// Frame rejected: hunt for the next sync, with rescan starting inside it
+static inline void rx_reject(el_ctx_t *ctx) {
+    ctx->state = EL_STATE_IDLE;
+    if (ctx->rescan) {
+        ctx->rx_replay = ctx->rx_raw;
+    }
+}
+
+// Length complete: pick the payload, skip or CRC state
+static void begin_payload(el_ctx_t *ctx) {
+    size_t max_len = ctx->rx_ext ? ctx->rx_buf_size : EL_MAX_PAYLOAD;
 
+    if (ctx->payload_len > max_len) {
+        // Invalid length (or too long for rx_buffer), reset
+        ctx->rx_len_errors++;
+        ctx->rx_errors++;
+        rx_reject(ctx);
+    } else if (rx_filtered(ctx, ctx->msg_id)) {
+        // Not wanted: drop payload and CRC unread
+        ctx->rx_filtered++;
+        ctx->skip_left = (uint32_t)ctx->payload_len + ctx->rx_crc_len;
+        ctx->state = EL_STATE_SKIP;
+    } else {
+        // Payload goes after the kept header bytes (none without rescan)
+        ctx->rx_base = ctx->rx_raw;
+        ctx->payload_idx = 0;
+        ctx->state = ctx->payload_len == 0 ? EL_STATE_GOT_PAYLOAD : EL_STATE_GOT_LEN;
+    }
+}
+
+// Check the CRC once its last byte is in, and deliver or reject the frame
+static void end_frame(el_ctx_t *ctx, bool ok) {
+    if (ok) {
+        ctx->state = EL_STATE_IDLE;
+        deliver(ctx, ctx->msg_id, &ctx->rx_buf[ctx->rx_base], ctx->payload_len);
+    } else {
+        ctx->rx_crc_errors++;
+        ctx->rx_errors++;
+        rx_reject(ctx);
+    }
+}
+
+// Advance the state machine by one byte (ctx already validated)
+static void parse_step(el_ctx_t *ctx, uint8_t byte) {
     switch (ctx->state) {
         case EL_STATE_IDLE:
-            if (byte == EL_SYNC_BYTE) {
-                ctx->state = EL_STATE_GOT_SYNC;
-                ctx->running_crc = 0;
+            if (rx_is_sync(ctx, byte)) {
+                rx_start_frame(ctx, byte);
+            } else {
+                ctx->rx_sync_discarded++;
             }
             break;
 
         case EL_STATE_GOT_SYNC:
             ctx->msg_id = byte;
-            ctx->running_crc = el_crc8_update(ctx->running_crc, byte);
+            rx_keep(ctx, byte);
+            rx_crc_byte(ctx, byte);
             ctx->state = EL_STATE_GOT_ID;
             break;
 
         case EL_STATE_GOT_ID:
             ctx->payload_len = byte;
-            ctx->running_crc = el_crc8_update(ctx->running_crc, byte);
+            rx_keep(ctx, byte);
+            rx_crc_byte(ctx, byte);
 
-            if (ctx->payload_len > EL_MAX_PAYLOAD) {
-                // Invalid length, reset
-                ctx->rx_errors++;
-                ctx->state = EL_STATE_IDLE;
-            } else if (ctx->payload_len == 0) {
-                // No payload, go straight to CRC
-                ctx->state = EL_STATE_GOT_PAYLOAD;
+            if (ctx->rx_ext) {
+                ctx->state = EL_STATE_GOT_LEN_LO;
+            } else if (ctx->rx_crc_len > 1) {
+                // Checked frame: CRC-8 of SYNC, MSG_ID and LENGTH follows
+                uint8_t sync = ctx->rx_crc_len == 4 ? EL_SYNC_CRC32 : EL_SYNC_CRC16;
+                ctx->rx_hchk = crc8_byte(crc8_byte(crc8_byte(0, sync), ctx->msg_id), byte);
+                ctx->state = EL_STATE_GOT_LEN_CHK;
             } else {
-                ctx->payload_idx = 0;
-                ctx->state = EL_STATE_GOT_LEN;
+                begin_payload(ctx);
             }
             break;
 
+        case EL_STATE_GOT_LEN_LO:
+            ctx->payload_len |= (uint16_t)byte << 8;
+            rx_keep(ctx, byte);
+            rx_crc_byte(ctx, byte);
+            begin_payload(ctx);
+            break;
+
+        case EL_STATE_GOT_LEN_CHK:
+            rx_keep(ctx, byte);
+            if (byte != ctx->rx_hchk) {
+                // Corrupt header: rejected before any payload is swallowed
+                ctx->rx_len_errors++;
+                ctx->rx_errors++;
+                rx_reject(ctx);
+                break;
+            }
+            rx_crc_byte(ctx, byte);
+            begin_payload(ctx);
+            break;
+
         case EL_STATE_GOT_LEN:
-            ctx->rx_buffer[ctx->payload_idx++] = byte;
-            ctx->running_crc = el_crc8_update(ctx->running_crc, byte);
+            ctx->rx_buf[ctx->rx_base + ctx->payload_idx++] = byte;
+            rx_crc_byte(ctx, byte);
 
             if (ctx->payload_idx >= ctx->payload_len) {
+                ctx->rx_raw = ctx->rx_base + ctx->payload_len;
                 ctx->state = EL_STATE_GOT_PAYLOAD;
             }
             break;
 
         case EL_STATE_GOT_PAYLOAD:
-            // Validate CRC
-            if (byte == ctx->running_crc) {
-                // Valid frame!
-                ctx->rx_frames++;
-                if (ctx->on_message) {
-                    ctx->on_message(ctx->msg_id, ctx->rx_buffer, ctx->payload_len);
-                }
-            } else {
-                // CRC mismatch
-                ctx->rx_errors++;
+            rx_keep(ctx, byte);
+            if (ctx->rx_crc_len == 1) {
+                end_frame(ctx, byte == ctx->running_crc);
+                break;
+            }
+
+            // Multi-byte CRCs run over their own bytes too and are checked
+            // by the residue: 0 for CRC-16 sent MSB first, a constant for
+            // CRC-32 sent LSB first
+            rx_crc_byte(ctx, byte);
+            ctx->crc_left = ctx->rx_crc_len - 1;
+            ctx->state = EL_STATE_GOT_CRC_HI;
+            break;
+
+        case EL_STATE_GOT_CRC_HI:
+            rx_keep(ctx, byte);
+            rx_crc_byte(ctx, byte);
+            if (--ctx->crc_left == 0) {
+                end_frame(ctx, ctx->running_crc == (ctx->rx_crc_len == 4 ? CRC32_RESIDUE : 0));
+            }
+            break;
+
+        case EL_STATE_SKIP:
+            if (--ctx->skip_left == 0) {
+                ctx->state = EL_STATE_IDLE;
             }
-            ctx->state = EL_STATE_IDLE;
             break;
     }
 }
 
+// Parse the bytes of a rejected frame again, from the byte after its sync.
+// They are read from rx_buf[0..n) while frames found among them are stored
+// from rx_buf[0] on, which always trails the read position by at least
+// their sync byte. If one of those is rejected too, its bytes are moved up
+// against the unread rest and the scan starts over; each rejection drops
+// a sync byte, so this ends.
+static void rx_rescan(el_ctx_t *ctx) {
+    size_t n = ctx->rx_replay;
+    size_t rd = 0;
+
+    ctx->rx_replay = 0;
+    while (rd < n) {
+        parse_step(ctx, ctx->rx_buf[rd++]);
+        if (ctx->rx_replay) {
+            size_t kept = ctx->rx_replay;
+            memmove(&ctx->rx_buf[kept], &ctx->rx_buf[rd], n - rd);
+            n = kept + (n - rd);
+            rd = 0;
+            ctx->rx_replay = 0;
+        }
+    }
+}
+
+static inline void parse_byte(el_ctx_t *ctx, uint8_t byte) {
+    parse_step(ctx, byte);
+    if (ctx->rx_replay) {
+        rx_rescan(ctx);
+    }
+}
+
+void el_process_byte(el_ctx_t *ctx, uint8_t byte) {
+    if (!ctx) return;
+    TRACE(EL_TRACE_PARSE_BEGIN, ctx, 1);
+    ctx->rx_bytes++;
+    parse_byte(ctx, byte);
+    TRACE(EL_TRACE_PARSE_END, ctx, 1);
+}
+
+// Handle a frame that lies entirely inside the caller's buffer without
+// staging it in rx_buffer: the payload is handed to the handler in place.
+// Returns the position just past the frame, or NULL if the frame is not
+// complete in [sync, end) or its header is bad, and it must go through the
+// state machine instead.
+static const uint8_t *parse_frame_inplace(el_ctx_t *ctx, const uint8_t *sync,
+                                          const uint8_t *end) {
+    bool ext = sync[0] == EL_SYNC_EXT;
+    bool checked = is_checked_sync(sync[0]);
+    size_t crc_len = sync[0] == EL_SYNC_BYTE ? 1 : sync[0] == EL_SYNC_CRC32 ? 4 : 2;
+    size_t hdr_len = ext || checked ? 4 : 3;
+    size_t overhead = hdr_len + crc_len;
+    size_t avail = (size_t)(end - sync);
+    if (avail < overhead) {
+        return NULL;
+    }
+
+    size_t payload_len = ext ? (size_t)sync[2] | ((size_t)sync[3] << 8) : sync[2];
+    size_t max_len = ext ? ctx->rx_buf_size : EL_MAX_PAYLOAD;
+    if (payload_len > max_len || avail < overhead + payload_len) {
+        return NULL;
+    }
+    if (checked && sync[3] != crc8_block(0, sync, 3)) {
+        return NULL;
+    }
+
+    const uint8_t *payload = sync + hdr_len;
+    const uint8_t *crc = payload + payload_len;
+    const uint8_t *next = crc + crc_len;
+
+    ctx->msg_id = sync[1];
+    ctx->payload_len = (uint16_t)payload_len;
+
+    if (rx_filtered(ctx, ctx->msg_id)) {
+        ctx->rx_filtered++;
+        return next;
+    }
+
+    // CRC covers everything between SYNC and the CRC itself
+    bool ok;
+    if (crc_len == 4) {
+        uint32_t sum = ~crc32_block(CRC32_INIT, &sync[1], hdr_len - 1 + payload_len);
+        ok = sum == ((uint32_t)crc[0] | ((uint32_t)crc[1] << 8) |
+                     ((uint32_t)crc[2] << 16) | ((uint32_t)crc[3] << 24));
+    } else if (crc_len == 2) {
+        uint16_t sum = crc16_block(CRC16_INIT, &sync[1], hdr_len - 1 + payload_len);
+        ok = sum == (uint16_t)((crc[0] << 8) | crc[1]);
+    } else {
+        ok = el_crc8(&sync[1], 2 + payload_len) == crc[0];
+    }
+
+    if (ok) {
+        deliver(ctx, ctx->msg_id, payload, payload_len);
+    } else {
+        ctx->rx_crc_errors++;
+        ctx->rx_errors++;
+        if (ctx->rescan) {
+            // The frame's bytes are still here: look for a sync inside it
+            return sync + 1;
+        }
+    }
+
+    return next;
+}
+
+// First byte in [p, end) that starts a frame this context accepts, or NULL
+static const uint8_t *find_sync(const el_ctx_t *ctx, const uint8_t *p, const uint8_t *end) {
+    const uint8_t *sync = memchr(p, EL_SYNC_BYTE, (size_t)(end - p));
+    if (!ctx->ext_frames && ctx->rx_crc == EL_CRC_8) {
+        return sync;
+    }
+
+    // Other sync bytes only count if they come first
+    uint8_t alt[3];
+    size_t alt_count = 0;
+    if (ctx->ext_frames) {
+        alt[alt_count++] = EL_SYNC_EXT;
+    }
+    if (ctx->rx_crc >= EL_CRC_16) {
+        alt[alt_count++] = EL_SYNC_CRC16;
+    }
+    if (ctx->rx_crc >= EL_CRC_32) {
+        alt[alt_count++] = EL_SYNC_CRC32;
+    }
+    for (size_t i = 0; i < alt_count; i++) {
+        const uint8_t *limit = sync ? sync : end;
+        const uint8_t *found = memchr(p, alt[i], (size_t)(limit - p));
+        if (found) {
+            sync = found;
+        }
+    }
+    return sync;
+}
+
+// Block-parse data (ctx already validated)
+static void parse_block(el_ctx_t *ctx, const uint8_t *data, size_t len) {
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+
+    // Block-oriented fast path. The states that consume runs of bytes
+    // (hunting for sync, receiving payload) are handled in bulk, and frames
+    // that arrive whole are delivered straight from the caller's buffer;
+    // the single-byte header/CRC states and frames split across calls go
+    // through the regular state machine, so behavior is identical to
+    // feeding the bytes one at a time.
+    while (p < end) {
+        switch (ctx->state) {
+            case EL_STATE_IDLE: {
+                // Skip noise up to the next sync byte in one pass
+                const uint8_t *sync = find_sync(ctx, p, end);
+                if (!sync) {
+                    ctx->rx_sync_discarded += (uint32_t)(end - p);
+                    return;
+                }
+                ctx->rx_sync_discarded += (uint32_t)(sync - p);
+
+                const uint8_t *next = parse_frame_inplace(ctx, sync, end);
+                if (next) {
+                    p = next;
+                    break;
+                }
+
+                rx_start_frame(ctx, *sync);
+                p = sync + 1;
+                break;
+            }
+
+            case EL_STATE_GOT_LEN: {
+                // Copy as much of the remaining payload as this chunk holds
+                size_t want = (size_t)(ctx->payload_len - ctx->payload_idx);
+                size_t avail = (size_t)(end - p);
+                size_t n = want < avail ? want : avail;
+
+                memcpy(&ctx->rx_buf[ctx->rx_base + ctx->payload_idx], p, n);
+                rx_crc_block(ctx, p, n);
+                ctx->payload_idx += (uint16_t)n;
+                p += n;
+
+                if (ctx->payload_idx >= ctx->payload_len) {
+                    ctx->rx_raw = ctx->rx_base + ctx->payload_len;
+                    ctx->state = EL_STATE_GOT_PAYLOAD;
+                }
+                break;
+            }
+
+            case EL_STATE_SKIP: {
+                // Filtered frame split across calls: step over the rest
+                size_t avail = (size_t)(end - p);
+                size_t n = ctx->skip_left < avail ? ctx->skip_left : avail;
+
+                ctx->skip_left -= (uint32_t)n;
+                p += n;
+
+                if (ctx->skip_left == 0) {
+                    ctx->state = EL_STATE_IDLE;
+                }
+                break;
+            }
+
+            default:
+                parse_byte(ctx, *p++);
+                break;
+        }
+    }
+}
+
 void el_process_bytes(el_ctx_t *ctx, const uint8_t *data, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        el_process_byte(ctx, data[i]);
+    if (!ctx || !data) return;
+    TRACE(EL_TRACE_PARSE_BEGIN, ctx, len);
+    ctx->rx_bytes += (uint32_t)len;
+    parse_block(ctx, data, len);
+    TRACE(EL_TRACE_PARSE_END, ctx, len);
+}
+
+/*******************************************************************************
+ * TX Ring
+ *
+ * Producer (el_send) owns head; the transport's sender task owns the
+ * read position. cons packs tail (end of space still in use) in the low
+ * half and read (start of frames not yet claimed) in the high half, so
+ * that EL_TX_DROP_OLDEST can advance both with one CAS while no claim is
+ * outstanding. Frames are stored in wire format, so a claim can be written
+ * to the transport as-is.
+ *
+ * In multi-producer mode producers CAS a 32-bit reserve position instead
+ * of writing head, and build their frames concurrently. The SYNC byte is
+ * stored last, with release semantics, and doubles as the publish flag:
+ * free space is kept zeroed (the consumer clears what it releases), so a
+ * frame start reads 0 until its producer is done. The consumer takes
+ * frames in reservation order and stops at the first unpublished one, so
+ * producers never wait on each other.
+ ******************************************************************************/
+
+#define TX_POS_MASK         0xFFFFu
+#define TX_CONS(tail, rd)   ((((uint32_t)(rd) & TX_POS_MASK) << 16) | ((uint32_t)(tail) & TX_POS_MASK))
+#define TX_TAIL(cons)       ((cons) & TX_POS_MASK)
+#define TX_READ(cons)       ((cons) >> 16)
+
+static void tx_ring_write(el_tx_ring_t *ring, uint32_t pos, const void *data, size_t len) {
+    size_t off = pos & (ring->size - 1);
+    size_t first = ring->size - off;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ring->buf[off], data, first);
+    memcpy(ring->buf, (const uint8_t *)data + first, len - first);
+}
+
+static inline bool tx_is_sync(uint8_t byte) {
+    return byte == EL_SYNC_BYTE || byte == EL_SYNC_EXT || is_checked_sync(byte);
+}
+
+// Wire length of the frame starting at pos (any sync byte)
+static uint32_t tx_frame_len(const el_tx_ring_t *ring, uint32_t pos) {
+    uint32_t mask = ring->size - 1;
+    uint8_t sync = ring->buf[pos & mask];
+    if (sync == EL_SYNC_EXT) {
+        return EL_EXT_OVERHEAD + (ring->buf[(pos + 2) & mask] |
+                                  ((uint32_t)ring->buf[(pos + 3) & mask] << 8));
+    }
+    uint32_t overhead = sync == EL_SYNC_CRC16 ? EL_CHK16_OVERHEAD :
+                        sync == EL_SYNC_CRC32 ? EL_CHK32_OVERHEAD : EL_FRAME_OVERHEAD;
+    return overhead + ring->buf[(pos + 2) & mask];
+}
+
+// Discard the oldest unclaimed frame. Returns false if nothing can be dropped.
+static bool tx_ring_drop_oldest(el_tx_ring_t *ring, uint32_t head) {
+    uint32_t cons = __atomic_load_n(&ring->cons, __ATOMIC_ACQUIRE);
+
+    while (1) {
+        uint32_t tail = TX_TAIL(cons);
+        uint32_t rd = TX_READ(cons);
+
+        // Claimed frames are being transmitted and free nothing until released
+        if (tail != rd || rd == head) {
+            return false;
+        }
+
+        uint32_t next = (rd + tx_frame_len(ring, rd)) & TX_POS_MASK;
+
+        if (__atomic_compare_exchange_n(&ring->cons, &cons, TX_CONS(next, next), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+}
+
+static void tx_ring_zero(el_tx_ring_t *ring, uint32_t pos, size_t len) {
+    size_t off = pos & (ring->size - 1);
+    size_t first = ring->size - off;
+    if (first > len) {
+        first = len;
+    }
+    memset(&ring->buf[off], 0, first);
+    memset(ring->buf, 0, len - first);
+}
+
+static void tx_note_high_water(el_ctx_t *ctx, uint32_t used) {
+    uint32_t hw = __atomic_load_n(&ctx->tx_high_water, __ATOMIC_RELAXED);
+    while (used > hw &&
+           !__atomic_compare_exchange_n(&ctx->tx_high_water, &hw, used, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static bool tx_ring_push_mp(el_ctx_t *ctx, const el_iovec_t *header,
+                            const el_iovec_t *iov, size_t iovcnt,
+                            const el_iovec_t *trailer, uint32_t frame_len) {
+    el_tx_ring_t *ring = &ctx->tx_ring;
+    uint32_t start = __atomic_load_n(&ring->reserve, __ATOMIC_RELAXED);
+    uint32_t used;
+
+    if (frame_len > ring->size) {
+        __atomic_fetch_add(&ctx->tx_drops, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    // Reserve space (a failed CAS reloads start and retries)
+    while (1) {
+        uint32_t tail = TX_TAIL(__atomic_load_n(&ring->cons, __ATOMIC_ACQUIRE));
+        used = (start - tail) & TX_POS_MASK;
+
+        if (ring->size - used < frame_len) {
+            if (ring->policy == EL_TX_BLOCK && ring->wait) {
+                ring->wait(ring->hook_user);
+                start = __atomic_load_n(&ring->reserve, __ATOMIC_RELAXED);
+                continue;
+            }
+            __atomic_fetch_add(&ctx->tx_drops, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+
+        if (__atomic_compare_exchange_n(&ring->reserve, &start, start + frame_len, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    // Build the frame in place, everything but the SYNC byte
+    const uint8_t *hdr = header->data;
+    uint32_t pos = start + 1;
+    tx_ring_write(ring, pos, &hdr[1], header->len - 1);
+    pos += (uint32_t)header->len - 1;
+    for (size_t i = 0; i < iovcnt; i++) {
+        tx_ring_write(ring, pos, iov[i].data, iov[i].len);
+        pos += (uint32_t)iov[i].len;
+    }
+    tx_ring_write(ring, pos, trailer->data, trailer->len);
+
+    // Publish
+    __atomic_store_n(&ring->buf[start & (ring->size - 1)], hdr[0], __ATOMIC_RELEASE);
+
+    tx_note_high_water(ctx, used + frame_len);
+    __atomic_fetch_add(&ctx->tx_frames, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&ctx->tx_bytes, frame_len, __ATOMIC_RELAXED);
+
+    if (ring->notify) {
+        ring->notify(ring->hook_user);
+    }
+
+    return true;
+}
+
+static bool tx_ring_push(el_ctx_t *ctx, const el_iovec_t *header,
+                         const el_iovec_t *iov, size_t iovcnt,
+                         const el_iovec_t *trailer, uint32_t frame_len) {
+    el_tx_ring_t *ring = &ctx->tx_ring;
+    uint32_t head = ring->head;
+    uint32_t used;
+
+    if (frame_len > ring->size) {
+        ctx->tx_drops++;
+        return false;
+    }
+
+    // Make room according to the ring policy
+    while (1) {
+        uint32_t tail = TX_TAIL(__atomic_load_n(&ring->cons, __ATOMIC_ACQUIRE));
+        used = (head - tail) & TX_POS_MASK;
+        if (ring->size - used >= frame_len) {
+            break;
+        }
+
+        if (ring->policy == EL_TX_DROP_OLDEST && tx_ring_drop_oldest(ring, head)) {
+            ctx->tx_drops++;
+            continue;
+        }
+        if (ring->policy == EL_TX_BLOCK && ring->wait) {
+            ring->wait(ring->hook_user);
+            continue;
+        }
+
+        ctx->tx_drops++;
+        return false;
     }
+
+    // Build the frame in place
+    uint32_t pos = head;
+    tx_ring_write(ring, pos, header->data, header->len);
+    pos += (uint32_t)header->len;
+    for (size_t i = 0; i < iovcnt; i++) {
+        tx_ring_write(ring, pos, iov[i].data, iov[i].len);
+        pos += (uint32_t)iov[i].len;
+    }
+    tx_ring_write(ring, pos, trailer->data, trailer->len);
+
+    // Publish
+    __atomic_store_n(&ring->head, (head + frame_len) & TX_POS_MASK, __ATOMIC_RELEASE);
+
+    if (used + frame_len > ctx->tx_high_water) {
+        ctx->tx_high_water = used + frame_len;
+    }
+    ctx->tx_frames++;
+    ctx->tx_bytes += frame_len;
+
+    if (ring->notify) {
+        ring->notify(ring->hook_user);
+    }
+
+    return true;
+}
+
+bool el_tx_attach(el_ctx_t *ctx, el_tx_hook_t notify, el_tx_hook_t wait, void *user) {
+    if (!ctx || !ctx->tx_ring.buf) {
+        return false;
+    }
+
+    ctx->tx_ring.hook_user = user;
+    ctx->tx_ring.wait = wait;
+    __atomic_store_n(&ctx->tx_ring.notify, notify, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool el_tx_async(const el_ctx_t *ctx) {
+    return ctx && ctx->tx_ring.buf;
+}
+
+size_t el_tx_claim(el_ctx_t *ctx, el_iovec_t span[2], size_t *count) {
+    *count = 0;
+    if (!ctx || !ctx->tx_ring.buf) {
+        return 0;
+    }
+
+    el_tx_ring_t *ring = &ctx->tx_ring;
+    uint32_t cons = __atomic_load_n(&ring->cons, __ATOMIC_ACQUIRE);
+    uint32_t rd;
+    uint32_t avail;
+
+    if (ring->multi_producer) {
+        // Walk published frames; only the consumer moves the read position
+        uint32_t end = __atomic_load_n(&ring->reserve, __ATOMIC_ACQUIRE) & TX_POS_MASK;
+        uint32_t mask = ring->size - 1;
+        uint32_t pos = rd = TX_READ(cons);
+
+        while (pos != end) {
+            uint8_t sync = __atomic_load_n(&ring->buf[pos & mask], __ATOMIC_ACQUIRE);
+            if (!tx_is_sync(sync)) {
+                break;
+            }
+            pos = (pos + tx_frame_len(ring, pos)) & TX_POS_MASK;
+        }
+
+        avail = (pos - rd) & TX_POS_MASK;
+        if (avail == 0) {
+            return 0;
+        }
+        __atomic_store_n(&ring->cons, TX_CONS(TX_TAIL(cons), pos), __ATOMIC_RELEASE);
+    } else {
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+        do {
+            rd = TX_READ(cons);
+            avail = (head - rd) & TX_POS_MASK;
+            if (avail == 0) {
+                return 0;
+            }
+            // Claim up to head; fails if the producer dropped a frame meanwhile
+        } while (!__atomic_compare_exchange_n(&ring->cons, &cons, TX_CONS(TX_TAIL(cons), head),
+                                              false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    }
+
+    size_t off = rd & (ring->size - 1);
+    size_t first = ring->size - off;
+    if (first > avail) {
+        first = avail;
+    }
+
+    span[0] = (el_iovec_t){ .data = &ring->buf[off], .len = first };
+    *count = 1;
+    if (first < avail) {
+        span[1] = (el_iovec_t){ .data = ring->buf, .len = avail - first };
+        *count = 2;
+    }
+
+    return avail;
+}
+
+void el_tx_release(el_ctx_t *ctx) {
+    if (!ctx || !ctx->tx_ring.buf) {
+        return;
+    }
+
+    // The producer never touches cons while a claim is outstanding
+    uint32_t cons = __atomic_load_n(&ctx->tx_ring.cons, __ATOMIC_ACQUIRE);
+    uint32_t rd = TX_READ(cons);
+
+    if (ctx->tx_ring.multi_producer) {
+        // Keep free space zeroed so unpublished frames never look published
+        tx_ring_zero(&ctx->tx_ring, TX_TAIL(cons), (rd - TX_TAIL(cons)) & TX_POS_MASK);
+    }
+
+    __atomic_store_n(&ctx->tx_ring.cons, TX_CONS(rd, rd), __ATOMIC_RELEASE);
 }
 
 bool el_send(el_ctx_t *ctx, uint8_t msg_id, const void *payload, uint8_t len) {
-    if (!ctx || !ctx->send_bytes) return false;
-    if (len > EL_MAX_PAYLOAD) return false;
     if (len > 0 && !payload) return false;
 
-    // Build frame in stack buffer
-    uint8_t frame[EL_FRAME_OVERHEAD + EL_MAX_PAYLOAD];
-    uint8_t frame_len = 0;
+    el_iovec_t seg = { .data = payload, .len = len };
+    return el_sendv(ctx, msg_id, &seg, 1);
+}
+
+// Flat transport: stage the frame and send it in one call. Kept out of
+// line so that the staging buffer only costs stack on this path, not in
+// every el_sendv caller.
+static __attribute__((noinline)) void send_flat(el_ctx_t *ctx, const el_iovec_t *hdr,
+                                                const el_iovec_t *iov, size_t iovcnt,
+                                                const el_iovec_t *crc, bool ext) {
+    if (ext) {
+        // Extended frame: too large to stage, send in pieces
+        ctx->send_bytes(hdr->data, hdr->len);
+        for (size_t i = 0; i < iovcnt; i++) {
+            if (iov[i].len > 0) {
+                ctx->send_bytes(iov[i].data, iov[i].len);
+            }
+        }
+        ctx->send_bytes(crc->data, crc->len);
+        return;
+    }
+
+    uint8_t frame[EL_MAX_FRAME];
+    size_t pos = 0;
+
+    memcpy(frame, hdr->data, hdr->len);
+    pos += hdr->len;
+
+    for (size_t i = 0; i < iovcnt; i++) {
+        if (iov[i].len > 0) {
+            memcpy(&frame[pos], iov[i].data, iov[i].len);
+            pos += iov[i].len;
+        }
+    }
+
+    memcpy(&frame[pos], crc->data, crc->len);
+    pos += crc->len;
+
+    ctx->send_bytes(frame, pos);
+}
+
+bool el_sendv(el_ctx_t *ctx, uint8_t msg_id, const el_iovec_t *iov, size_t iovcnt) {
+    if (!ctx || (!ctx->send_bytes && !ctx->send_bytesv && !ctx->tx_ring.buf)) return false;
+    if (iovcnt > EL_MAX_IOV || (iovcnt > 0 && !iov)) return false;
+
+    size_t len = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        if (iov[i].len > 0 && !iov[i].data) return false;
+        len += iov[i].len;
+    }
+
+    bool ext = len > EL_MAX_PAYLOAD;
+    if (ext && (!ctx->ext_frames || len > EL_EXT_MAX_PAYLOAD)) return false;
+
+    // Header and CRC trailer (CRC over everything after SYNC, accumulated
+    // segment by segment); CRC-16 goes out MSB first, CRC-32 LSB first
+    uint8_t header[4];
+    uint8_t trailer[4];
+    el_iovec_t hdr_seg;
+    el_iovec_t crc_seg;
+
+    if (!ext && ctx->tx_crc != EL_CRC_8) {
+        // Checked frame, with a CRC-8 of the first three bytes in HCHK
+        header[0] = ctx->tx_crc == EL_CRC_32 ? EL_SYNC_CRC32 : EL_SYNC_CRC16;
+        header[1] = msg_id;
+        header[2] = (uint8_t)len;
+        header[3] = crc8_block(0x00, header, 3);
+
+        if (ctx->tx_crc == EL_CRC_32) {
+            uint32_t crc = crc32_block(CRC32_INIT, &header[1], 3);
+            for (size_t i = 0; i < iovcnt; i++) {
+                crc = crc32_block(crc, iov[i].data, iov[i].len);
+            }
+            crc = ~crc;
+            trailer[0] = (uint8_t)crc;
+            trailer[1] = (uint8_t)(crc >> 8);
+            trailer[2] = (uint8_t)(crc >> 16);
+            trailer[3] = (uint8_t)(crc >> 24);
+            crc_seg = (el_iovec_t){ .data = trailer, .len = 4 };
+        } else {
+            uint16_t crc = crc16_block(CRC16_INIT, &header[1], 3);
+            for (size_t i = 0; i < iovcnt; i++) {
+                crc = crc16_block(crc, iov[i].data, iov[i].len);
+            }
+            trailer[0] = (uint8_t)(crc >> 8);
+            trailer[1] = (uint8_t)crc;
+            crc_seg = (el_iovec_t){ .data = trailer, .len = 2 };
+        }
+
+        hdr_seg = (el_iovec_t){ .data = header, .len = 4 };
+    } else if (ext) {
+        header[0] = EL_SYNC_EXT;
+        header[1] = msg_id;
+        header[2] = (uint8_t)len;
+        header[3] = (uint8_t)(len >> 8);
 
-    // Header
-    frame[frame_len++] = EL_SYNC_BYTE;
-    frame[frame_len++] = msg_id;
-    frame[frame_len++] = len;
+        uint16_t crc = crc16_block(CRC16_INIT, &header[1], 3);
+        for (size_t i = 0; i < iovcnt; i++) {
+            crc = crc16_block(crc, iov[i].data, iov[i].len);
+        }
+        trailer[0] = (uint8_t)(crc >> 8);
+        trailer[1] = (uint8_t)crc;
 
-    // Payload
-    if (len > 0) {
-        memcpy(&frame[frame_len], payload, len);
-        frame_len += len;
+        hdr_seg = (el_iovec_t){ .data = header, .len = 4 };
+        crc_seg = (el_iovec_t){ .data = trailer, .len = 2 };
+    } else {
+        header[0] = EL_SYNC_BYTE;
+        header[1] = msg_id;
+        header[2] = (uint8_t)len;
+
+        uint8_t crc = crc8_block(0x00, &header[1], 2);
+        for (size_t i = 0; i < iovcnt; i++) {
+            crc = crc8_block(crc, iov[i].data, iov[i].len);
+        }
+        trailer[0] = crc;
+
+        hdr_seg = (el_iovec_t){ .data = header, .len = 3 };
+        crc_seg = (el_iovec_t){ .data = trailer, .len = 1 };
     }
 
-    // CRC (over msg_id + len + payload)
-    uint8_t crc = el_crc8(&frame[1], 2 + len);
-    frame[frame_len++] = crc;
+    size_t frame_len = hdr_seg.len + len + crc_seg.len;
+
+    if (ctx->tx_ring.buf) {
+        // Asynchronous: queue for the transport's sender task
+        if (ctx->tx_ring.multi_producer) {
+            return tx_ring_push_mp(ctx, &hdr_seg, iov, iovcnt, &crc_seg, (uint32_t)frame_len);
+        }
+        return tx_ring_push(ctx, &hdr_seg, iov, iovcnt, &crc_seg, (uint32_t)frame_len);
+    }
+
+    if (ctx->send_bytesv) {
+        // Hand header, payload segments and CRC to the transport as-is
+        el_iovec_t out[EL_MAX_IOV + 2];
+        size_t n = 0;
+
+        out[n++] = hdr_seg;
+        for (size_t i = 0; i < iovcnt; i++) {
+            if (iov[i].len > 0) {
+                out[n++] = iov[i];
+            }
+        }
+        out[n++] = crc_seg;
+
+        ctx->send_bytesv(ctx->send_user, out, n);
+    } else {
+        send_flat(ctx, &hdr_seg, iov, iovcnt, &crc_seg, ext);
+    }
 
-    // Transmit
-    ctx->send_bytes(frame, frame_len);
     ctx->tx_frames++;
+    ctx->tx_bytes += (uint32_t)frame_len;
+
+    return true;
+}
+
+bool el_send_ext(el_ctx_t *ctx, uint8_t msg_id, const void *payload, size_t len) {
+    if (len > 0 && !payload) return false;
 
+    el_iovec_t seg = { .data = payload, .len = len };
+    return el_sendv(ctx, msg_id, &seg, 1);
+}
+
+void el_flush(el_ctx_t *ctx) {
+    if (ctx && ctx->flush) {
+        ctx->flush(ctx->send_user);
+    }
+}
+
+/*******************************************************************************
+ * Statistics
+ ******************************************************************************/
+
+void el_get_stats(const el_ctx_t *ctx, el_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (!ctx) {
+        return;
+    }
+
+    stats->rx_frames = ctx->rx_frames;
+    stats->rx_bytes = ctx->rx_bytes;
+    stats->rx_crc_errors = ctx->rx_crc_errors;
+    stats->rx_len_errors = ctx->rx_len_errors;
+    stats->rx_sync_discarded = ctx->rx_sync_discarded;
+    stats->rx_unhandled = ctx->rx_unhandled;
+    stats->rx_bad_length = ctx->rx_bad_length;
+    stats->rx_filtered = ctx->rx_filtered;
+    stats->tx_frames = __atomic_load_n(&ctx->tx_frames, __ATOMIC_RELAXED);
+    stats->tx_bytes = __atomic_load_n(&ctx->tx_bytes, __ATOMIC_RELAXED);
+    stats->tx_drops = __atomic_load_n(&ctx->tx_drops, __ATOMIC_RELAXED);
+    stats->tx_high_water = __atomic_load_n(&ctx->tx_high_water, __ATOMIC_RELAXED);
+    stats->rx_cb_max = ctx->rx_cb_max;
+
+    if (ctx->stats_hook) {
+        ctx->stats_hook(ctx->stats_user, stats);
+    }
+}
+
+void el_set_stats_hook(el_ctx_t *ctx, el_stats_hook_t hook, void *user) {
+    if (ctx) {
+        ctx->stats_hook = hook;
+        ctx->stats_user = user;
+    }
+}
+
+// el_stats_t is all uint32_t, so reports walk it as an array in
+// declaration order
+_Static_assert(sizeof(el_stats_t) == EL_STATS_FIELDS * sizeof(uint32_t), "update EL_STATS_FIELDS");
+
+bool el_send_stats(el_ctx_t *ctx) {
+    if (!ctx) {
+        return false;
+    }
+
+    el_stats_t stats;
+    uint32_t fields[EL_STATS_FIELDS];
+    uint8_t report[EL_STATS_REPORT_LEN];
+
+    el_get_stats(ctx, &stats);
+    memcpy(fields, &stats, sizeof(fields));
+
+    report[0] = EL_STATS_VERSION;
+    for (size_t i = 0; i < EL_STATS_FIELDS; i++) {
+        uint8_t *p = &report[1 + 4 * i];
+        p[0] = (uint8_t)fields[i];
+        p[1] = (uint8_t)(fields[i] >> 8);
+        p[2] = (uint8_t)(fields[i] >> 16);
+        p[3] = (uint8_t)(fields[i] >> 24);
+    }
+
+    return el_send(ctx, EL_MSG_STATS, report, sizeof(report));
+}
+
+bool el_stats_decode(const void *payload, uint8_t len, el_stats_t *stats) {
+    const uint8_t *p = payload;
+    if (!p || !stats || len < EL_STATS_REPORT_LEN || p[0] != EL_STATS_VERSION) {
+        return false;
+    }
+
+    uint32_t fields[EL_STATS_FIELDS];
+    for (size_t i = 0; i < EL_STATS_FIELDS; i++) {
+        const uint8_t *f = &p[1 + 4 * i];
+        fields[i] = (uint32_t)f[0] | ((uint32_t)f[1] << 8) |
+                    ((uint32_t)f[2] << 16) | ((uint32_t)f[3] << 24);
+    }
+    memcpy(stats, fields, sizeof(fields));
     return true;
 }
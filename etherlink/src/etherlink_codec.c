@@ -0,0 +1,254 @@
+/**
+ * Etherlink Payload Codec - Implementation
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink_codec.h"
+#include <string.h>
+
+#define DELTA_HDR_SIZE      2       // Original msg_id + seq
+#define VARINT_MAX_SIZE     5       // 32-bit value, 7 bits per byte
+
+/*******************************************************************************
+ * Field Coding
+ *
+ * A field's delta is taken modulo its width and sign-extended, so a w-byte
+ * field always codes into at most w * 8 + 1 bits of zigzag varint no
+ * matter whether the field is signed, and decoding wraps back exactly.
+ ******************************************************************************/
+
+static uint32_t load_field(const uint8_t *p, uint8_t width) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < width; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static void store_field(uint8_t *p, uint8_t width, uint32_t v) {
+    for (uint8_t i = 0; i < width; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t zigzag(uint32_t delta, uint8_t width) {
+    // Sign-extend the width-bit delta, then interleave negatives
+    uint32_t shift = 32 - 8 * (uint32_t)width;
+    int32_t d = (int32_t)(delta << shift) >> shift;
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+static uint32_t unzigzag(uint32_t zz) {
+    return (zz >> 1) ^ (0u - (zz & 1));
+}
+
+static size_t varint_put(uint8_t *out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Returns bytes consumed, or 0 if the varint is truncated or too long
+static size_t varint_get(const uint8_t *in, size_t avail, uint32_t *v) {
+    uint32_t result = 0;
+    for (size_t n = 0; n < avail && n < VARINT_MAX_SIZE; n++) {
+        result |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if (!(in[n] & 0x80)) {
+            *v = result;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static el_codec_stream_t *find_stream(el_codec_t *codec, uint8_t msg_id) {
+    for (size_t i = 0; i < codec->stream_count; i++) {
+        if (codec->streams[i].msg_id == msg_id) {
+            return &codec->streams[i];
+        }
+    }
+    return NULL;
+}
+
+// Code cur against tx_ref into out. Returns the coded length, or 0 if it
+// would not be shorter than the raw payload.
+static size_t encode_delta(const el_codec_stream_t *s, const uint8_t *cur,
+                           uint8_t seq, uint8_t *out) {
+    size_t n = 0;
+    size_t off = 0;
+
+    out[n++] = s->msg_id;
+    out[n++] = seq;
+
+    for (uint8_t i = 0; i < s->field_count; i++) {
+        uint8_t w = s->fields[i];
+        uint32_t delta = load_field(&cur[off], w) - load_field(&s->tx_ref[off], w);
+        n += varint_put(&out[n], zigzag(delta, w));
+        off += w;
+
+        if (n >= s->size) {
+            return 0;
+        }
+    }
+
+    return n;
+}
+
+// Apply a coded delta to rx_ref in place. Returns false if malformed.
+static bool decode_delta(el_codec_stream_t *s, const uint8_t *in, size_t len) {
+    size_t pos = 0;
+    size_t off = 0;
+
+    for (uint8_t i = 0; i < s->field_count; i++) {
+        uint8_t w = s->fields[i];
+        uint32_t zz;
+        size_t used = varint_get(&in[pos], len - pos, &zz);
+        if (used == 0) {
+            return false;
+        }
+        pos += used;
+
+        store_field(&s->rx_ref[off], w, load_field(&s->rx_ref[off], w) + unzigzag(zz));
+        off += w;
+    }
+
+    return pos == len;
+}
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+bool el_codec_init(el_codec_t *codec, el_codec_stream_t *streams, size_t count) {
+    if (!codec || (!streams && count > 0)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        el_codec_stream_t *s = &streams[i];
+        size_t size = 0;
+
+        if (s->msg_id == EL_MSG_DELTA || !s->fields || s->field_count == 0) {
+            return false;
+        }
+        for (uint8_t f = 0; f < s->field_count; f++) {
+            if (s->fields[f] != 1 && s->fields[f] != 2 && s->fields[f] != 4) {
+                return false;
+            }
+            size += s->fields[f];
+        }
+        if (size > EL_MAX_PAYLOAD) {
+            return false;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (streams[j].msg_id == s->msg_id) {
+                return false;
+            }
+        }
+
+        s->size = (uint8_t)size;
+    }
+
+    memset(codec, 0, sizeof(*codec));
+    codec->streams = streams;
+    codec->stream_count = count;
+    el_codec_reset(codec);
+    return true;
+}
+
+void el_codec_reset(el_codec_t *codec) {
+    if (!codec) {
+        return;
+    }
+
+    for (size_t i = 0; i < codec->stream_count; i++) {
+        codec->streams[i].tx_seq = 0;
+        codec->streams[i].rx_seq = 0;
+        codec->streams[i].tx_valid = false;
+        codec->streams[i].rx_valid = false;
+    }
+}
+
+bool el_codec_send(el_ctx_t *ctx, el_codec_t *codec, uint8_t msg_id,
+                   const void *payload, uint8_t len) {
+    el_codec_stream_t *s = codec ? find_stream(codec, msg_id) : NULL;
+    if (!s || !s->tx_ref || len != s->size) {
+        return el_send(ctx, msg_id, payload, len);
+    }
+
+    uint8_t interval = s->keyframe_interval ? s->keyframe_interval
+                                            : EL_CODEC_KEYFRAME_DEFAULT;
+    uint8_t coded[EL_MAX_PAYLOAD + VARINT_MAX_SIZE];
+    size_t n = 0;
+
+    if (s->tx_valid && s->tx_seq + 1 < interval) {
+        n = encode_delta(s, payload, (uint8_t)(s->tx_seq + 1), coded);
+    }
+
+    bool ok;
+    if (n > 0) {
+        ok = el_send(ctx, EL_MSG_DELTA, coded, (uint8_t)n);
+        if (ok) {
+            s->tx_seq++;
+            codec->tx_deltas++;
+        }
+    } else {
+        // Keyframe: the payload as is, readable without the codec
+        ok = el_send(ctx, msg_id, payload, len);
+        if (ok) {
+            s->tx_seq = 0;
+            codec->tx_keyframes++;
+        }
+        n = len;
+    }
+
+    if (ok) {
+        memcpy(s->tx_ref, payload, len);
+        s->tx_valid = true;
+        codec->tx_raw_bytes += len;
+        codec->tx_payload_bytes += n;
+    }
+    return ok;
+}
+
+bool el_codec_rx(el_codec_t *codec, uint8_t *msg_id, const uint8_t **payload, uint8_t *len) {
+    if (*msg_id != EL_MSG_DELTA) {
+        // A raw frame of a coded stream is its next keyframe
+        el_codec_stream_t *s = find_stream(codec, *msg_id);
+        if (s && s->rx_ref && *len == s->size) {
+            memcpy(s->rx_ref, *payload, *len);
+            s->rx_seq = 0;
+            s->rx_valid = true;
+        }
+        return true;
+    }
+
+    const uint8_t *in = *payload;
+    el_codec_stream_t *s = *len >= DELTA_HDR_SIZE ? find_stream(codec, in[0]) : NULL;
+    if (!s || !s->rx_ref || !s->rx_valid || in[1] != (uint8_t)(s->rx_seq + 1)) {
+        // Unknown stream, or missed a frame: wait for the next keyframe
+        if (s) {
+            s->rx_valid = false;
+        }
+        codec->rx_dropped++;
+        return false;
+    }
+
+    if (!decode_delta(s, &in[DELTA_HDR_SIZE], *len - DELTA_HDR_SIZE)) {
+        s->rx_valid = false;
+        codec->rx_dropped++;
+        return false;
+    }
+
+    s->rx_seq++;
+    codec->rx_deltas++;
+    *msg_id = s->msg_id;
+    *payload = s->rx_ref;
+    *len = s->size;
+    return true;
+}
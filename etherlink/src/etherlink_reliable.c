@@ -0,0 +1,431 @@
+/**
+ * Etherlink Reliable Channel - Implementation
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink_reliable.h"
+#include <string.h>
+
+#define DEFAULT_RTO_INITIAL_MS  250
+#define DEFAULT_RTO_MIN_MS      20
+#define DEFAULT_RTO_MAX_MS      2000
+#define DEFAULT_MAX_RETRIES     8
+#define DEFAULT_ACK_EVERY       4
+#define DEFAULT_ACK_DELAY_MS    5
+
+#define ACK_SIZE                6       // next seq + 32-bit bitmap
+
+/*******************************************************************************
+ * Helpers
+ *
+ * Sequence numbers wrap at 16 bits and are compared by signed difference.
+ * Window sizes are powers of two, so seq % window stays continuous across
+ * the wrap and each in-flight seq owns one slot.
+ ******************************************************************************/
+
+static inline int16_t seq_diff(uint16_t a, uint16_t b) {
+    return (int16_t)(uint16_t)(a - b);
+}
+
+static inline bool valid_window(uint8_t n) {
+    return n > 0 && n <= EL_REL_WINDOW_MAX && (n & (n - 1)) == 0;
+}
+
+static inline void rel_lock(el_rel_t *rel) {
+    if (rel->cfg.lock) {
+        rel->cfg.lock(rel->cfg.hook_user);
+    }
+}
+
+static inline void rel_unlock(el_rel_t *rel) {
+    if (rel->cfg.unlock) {
+        rel->cfg.unlock(rel->cfg.hook_user);
+    }
+}
+
+static inline el_rel_slot_t *tx_slot(el_rel_t *rel, uint16_t seq) {
+    return &rel->cfg.tx_slots[seq & (rel->cfg.tx_window - 1)];
+}
+
+static inline el_rel_slot_t *rx_slot(el_rel_t *rel, uint16_t seq) {
+    return &rel->cfg.rx_slots[seq & (rel->cfg.rx_window - 1)];
+}
+
+static void transmit(el_rel_t *rel, el_rel_slot_t *slot, uint32_t now) {
+    slot->sent_ms = now;
+    slot->tries++;
+    el_send(rel->cfg.ctx, EL_MSG_REL_DATA, slot->frame, slot->len);
+}
+
+static void send_ack(el_rel_t *rel) {
+    uint8_t ack[ACK_SIZE] = {
+        (uint8_t)rel->rx_next, (uint8_t)(rel->rx_next >> 8),
+        (uint8_t)rel->rx_held, (uint8_t)(rel->rx_held >> 8),
+        (uint8_t)(rel->rx_held >> 16), (uint8_t)(rel->rx_held >> 24),
+    };
+
+    rel->ack_pending = 0;
+    rel->acks_sent++;
+    el_send(rel->cfg.ctx, EL_MSG_REL_ACK, ack, sizeof(ack));
+}
+
+// RFC 6298 estimator, in whole milliseconds
+static void rtt_sample(el_rel_t *rel, uint32_t rtt) {
+    if (rel->srtt_ms == 0) {
+        rel->srtt_ms = rtt ? rtt : 1;
+        rel->rttvar_ms = rtt / 2;
+    } else {
+        uint32_t err = rel->srtt_ms > rtt ? rel->srtt_ms - rtt : rtt - rel->srtt_ms;
+        rel->rttvar_ms = (3 * rel->rttvar_ms + err) / 4;
+        rel->srtt_ms = (7 * rel->srtt_ms + rtt) / 8;
+        if (rel->srtt_ms == 0) {
+            rel->srtt_ms = 1;
+        }
+    }
+
+    uint32_t var = 4 * rel->rttvar_ms;
+    uint32_t rto = rel->srtt_ms + (var ? var : 1);
+    if (rto < rel->cfg.rto_min_ms) {
+        rto = rel->cfg.rto_min_ms;
+    } else if (rto > rel->cfg.rto_max_ms) {
+        rto = rel->cfg.rto_max_ms;
+    }
+    rel->rto_ms = rto;
+}
+
+static void ack_slot(el_rel_t *rel, el_rel_slot_t *slot, uint32_t now) {
+    if (!slot->acked) {
+        slot->acked = true;
+        // Karn's rule: a retransmitted frame gives no usable sample
+        if (slot->tries == 1) {
+            rtt_sample(rel, now - slot->sent_ms);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Receive
+ ******************************************************************************/
+
+// Returns true if tx slots were freed
+static bool handle_ack(el_rel_t *rel, const uint8_t *payload, uint8_t len) {
+    if (len != ACK_SIZE || !rel->cfg.tx_slots) {
+        return false;
+    }
+
+    uint16_t next = (uint16_t)(payload[0] | (payload[1] << 8));
+    uint32_t bits = (uint32_t)payload[2] | ((uint32_t)payload[3] << 8) |
+                    ((uint32_t)payload[4] << 16) | ((uint32_t)payload[5] << 24);
+
+    // An ACK from before the last one (reordered) or for unsent frames
+    int16_t d = seq_diff(next, rel->tx_base);
+    if (d < 0 || d > seq_diff(rel->tx_next, rel->tx_base)) {
+        return false;
+    }
+
+    uint32_t now = rel->cfg.now_ms();
+    rel->acks_received++;
+
+    // Cumulative part
+    for (uint16_t s = rel->tx_base; s != next; s++) {
+        ack_slot(rel, tx_slot(rel, s), now);
+    }
+
+    // Selective part
+    uint16_t highest = next;
+    bool sacked = false;
+    for (uint8_t i = 0; i < 32 && bits; i++, bits >>= 1) {
+        uint16_t s = (uint16_t)(next + 1 + i);
+        if (seq_diff(s, rel->tx_next) >= 0) {
+            break;
+        }
+        if (bits & 1) {
+            ack_slot(rel, tx_slot(rel, s), now);
+            highest = s;
+            sacked = true;
+        }
+    }
+
+    bool freed = false;
+    while (rel->tx_base != rel->tx_next && tx_slot(rel, rel->tx_base)->acked) {
+        el_rel_slot_t *slot = tx_slot(rel, rel->tx_base);
+        slot->used = false;
+        slot->acked = false;
+        rel->tx_base++;
+        freed = true;
+    }
+
+    // Gaps below a selectively acknowledged frame are NACKs. Resend them
+    // now, but at most once per RTT so a run of ACKs reporting the same
+    // gap does not resend it each time.
+    if (sacked) {
+        uint32_t guard = rel->srtt_ms ? rel->srtt_ms : rel->cfg.rto_min_ms;
+        for (uint16_t s = rel->tx_base; seq_diff(s, highest) < 0; s++) {
+            el_rel_slot_t *slot = tx_slot(rel, s);
+            if (!slot->acked && now - slot->sent_ms >= guard) {
+                transmit(rel, slot, now);
+                rel->tx_retransmits++;
+            }
+        }
+    }
+
+    return freed;
+}
+
+static void handle_data(el_rel_t *rel, const uint8_t *payload, uint8_t len) {
+    if (len < EL_REL_HDR_SIZE) {
+        rel->cfg.ctx->rx_bad_length++;
+        return;
+    }
+
+    uint16_t seq = (uint16_t)(payload[0] | (payload[1] << 8));
+
+    rel_lock(rel);
+
+    int16_t d = seq_diff(seq, rel->rx_next);
+    if (d != 0) {
+        if (d < 0) {
+            // Already delivered: our ACK was probably lost
+            rel->rx_duplicates++;
+        } else if (d < rel->cfg.rx_window) {
+            uint32_t bit = 1u << (d - 1);
+            if (rel->rx_held & bit) {
+                rel->rx_duplicates++;
+            } else {
+                el_rel_slot_t *slot = rx_slot(rel, seq);
+                memcpy(slot->frame, payload, len);
+                slot->len = len;
+                rel->rx_held |= bit;
+                rel->rx_out_of_order++;
+            }
+        } else {
+            rel->rx_dropped++;
+        }
+
+        // Report the gap immediately, so the sender can fill it
+        send_ack(rel);
+        rel_unlock(rel);
+        return;
+    }
+
+    // In order: deliver it, then whatever it unblocks from the rx slots.
+    // Only this (receiving) task touches rx slots, so the callbacks run
+    // without the lock held.
+    const uint8_t *frame = payload;
+    uint8_t frame_len = len;
+
+    while (1) {
+        bool more = rel->rx_held & 1;
+        rel->rx_next++;
+        rel->rx_held >>= 1;
+        if (rel->ack_pending++ == 0) {
+            rel->ack_since_ms = rel->cfg.now_ms();
+        }
+        rel_unlock(rel);
+
+        if (rel->cfg.on_message) {
+            rel->cfg.on_message(rel->cfg.user, frame[2], &frame[EL_REL_HDR_SIZE],
+                                (uint8_t)(frame_len - EL_REL_HDR_SIZE));
+        }
+        rel->rx_delivered++;
+
+        rel_lock(rel);
+        if (!more) {
+            break;
+        }
+        el_rel_slot_t *slot = rx_slot(rel, rel->rx_next);
+        frame = slot->frame;
+        frame_len = slot->len;
+    }
+
+    if (rel->ack_pending >= rel->cfg.ack_every) {
+        send_ack(rel);
+    }
+    rel_unlock(rel);
+}
+
+void el_rel_rx(el_rel_t *rel, uint8_t msg_id, const uint8_t *payload, uint8_t len) {
+    if (msg_id == EL_MSG_REL_DATA) {
+        handle_data(rel, payload, len);
+        return;
+    }
+
+    rel_lock(rel);
+    bool freed = handle_ack(rel, payload, len);
+    rel_unlock(rel);
+
+    if (freed && rel->cfg.notify) {
+        rel->cfg.notify(rel->cfg.hook_user);
+    }
+}
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+bool el_rel_init(el_rel_t *rel, const el_rel_config_t *config) {
+    if (!rel || !config || !config->ctx || !config->now_ms) {
+        return false;
+    }
+    if (config->tx_slots && !valid_window(config->tx_window)) {
+        return false;
+    }
+    if (config->rx_slots && !valid_window(config->rx_window)) {
+        return false;
+    }
+
+    memset(rel, 0, sizeof(*rel));
+    rel->cfg = *config;
+    if (!rel->cfg.rx_slots) {
+        rel->cfg.rx_window = 0;
+    }
+    if (rel->cfg.rto_initial_ms == 0) {
+        rel->cfg.rto_initial_ms = DEFAULT_RTO_INITIAL_MS;
+    }
+    if (rel->cfg.rto_min_ms == 0) {
+        rel->cfg.rto_min_ms = DEFAULT_RTO_MIN_MS;
+    }
+    if (rel->cfg.rto_max_ms == 0) {
+        rel->cfg.rto_max_ms = DEFAULT_RTO_MAX_MS;
+    }
+    if (rel->cfg.max_retries == 0) {
+        rel->cfg.max_retries = DEFAULT_MAX_RETRIES;
+    }
+    if (rel->cfg.ack_every == 0) {
+        rel->cfg.ack_every = DEFAULT_ACK_EVERY;
+    }
+    if (rel->cfg.ack_delay_ms == 0) {
+        rel->cfg.ack_delay_ms = DEFAULT_ACK_DELAY_MS;
+    }
+
+    el_rel_reset(rel);
+    config->ctx->reliable = rel;
+    return true;
+}
+
+void el_rel_reset(el_rel_t *rel) {
+    if (!rel) {
+        return;
+    }
+
+    rel_lock(rel);
+    rel->tx_base = 0;
+    rel->tx_next = 0;
+    rel->srtt_ms = 0;
+    rel->rttvar_ms = 0;
+    rel->rto_ms = rel->cfg.rto_initial_ms;
+    rel->failed = false;
+    rel->rx_next = 0;
+    rel->rx_held = 0;
+    rel->ack_pending = 0;
+    for (uint8_t i = 0; rel->cfg.tx_slots && i < rel->cfg.tx_window; i++) {
+        rel->cfg.tx_slots[i].used = false;
+        rel->cfg.tx_slots[i].acked = false;
+    }
+    rel_unlock(rel);
+}
+
+bool el_rel_send(el_rel_t *rel, uint8_t msg_id, const void *payload, uint8_t len) {
+    if (!rel || !rel->cfg.tx_slots || len > EL_REL_MAX_PAYLOAD || (len > 0 && !payload)) {
+        return false;
+    }
+
+    rel_lock(rel);
+    while (1) {
+        if (rel->failed) {
+            rel_unlock(rel);
+            return false;
+        }
+        if ((uint16_t)(rel->tx_next - rel->tx_base) < rel->cfg.tx_window) {
+            break;
+        }
+        if (rel->cfg.wait) {
+            rel_unlock(rel);
+            rel->cfg.wait(rel->cfg.hook_user);
+            rel_lock(rel);
+            continue;
+        }
+        rel->tx_window_full++;
+        rel_unlock(rel);
+        return false;
+    }
+
+    el_rel_slot_t *slot = tx_slot(rel, rel->tx_next);
+    slot->frame[0] = (uint8_t)rel->tx_next;
+    slot->frame[1] = (uint8_t)(rel->tx_next >> 8);
+    slot->frame[2] = msg_id;
+    if (len > 0) {
+        memcpy(&slot->frame[EL_REL_HDR_SIZE], payload, len);
+    }
+    slot->len = (uint8_t)(EL_REL_HDR_SIZE + len);
+    slot->used = true;
+    slot->acked = false;
+    slot->tries = 0;
+
+    rel->tx_next++;
+    rel->tx_frames++;
+    transmit(rel, slot, rel->cfg.now_ms());
+
+    rel_unlock(rel);
+    return true;
+}
+
+uint32_t el_rel_poll(el_rel_t *rel) {
+    if (!rel) {
+        return 0;
+    }
+
+    rel_lock(rel);
+    uint32_t now = rel->cfg.now_ms();
+    uint32_t due = rel->rto_ms;
+
+    // Retransmit timers
+    bool expired = false;
+    for (uint16_t s = rel->tx_base; !rel->failed && s != rel->tx_next; s++) {
+        el_rel_slot_t *slot = tx_slot(rel, s);
+        if (slot->acked) {
+            continue;
+        }
+
+        uint32_t elapsed = now - slot->sent_ms;
+        if (elapsed < rel->rto_ms) {
+            if (rel->rto_ms - elapsed < due) {
+                due = rel->rto_ms - elapsed;
+            }
+            continue;
+        }
+
+        if (slot->tries > rel->cfg.max_retries) {
+            rel->failed = true;
+            break;
+        }
+        transmit(rel, slot, now);
+        rel->tx_retransmits++;
+        expired = true;
+    }
+
+    if (expired) {
+        // Back off until a fresh sample brings the RTO down again
+        rel->tx_timeouts++;
+        rel->rto_ms = rel->rto_ms * 2 > rel->cfg.rto_max_ms ? rel->cfg.rto_max_ms
+                                                             : rel->rto_ms * 2;
+    }
+
+    // Delayed ACK
+    if (rel->ack_pending) {
+        uint32_t elapsed = now - rel->ack_since_ms;
+        if (elapsed >= rel->cfg.ack_delay_ms) {
+            send_ack(rel);
+        } else if (rel->cfg.ack_delay_ms - elapsed < due) {
+            due = rel->cfg.ack_delay_ms - elapsed;
+        }
+    }
+
+    rel_unlock(rel);
+    return due;
+}
+
+bool el_rel_idle(const el_rel_t *rel) {
+    return !rel || rel->tx_base == rel->tx_next;
+}
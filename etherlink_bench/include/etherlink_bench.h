@@ -0,0 +1,233 @@
+/**
+ * Etherlink Benchmark
+ *
+ * Measures a link end to end with EL_MSG_PING / EL_MSG_PONG round trips.
+ * The peer answers each PING with a PONG carrying the same payload, which
+ * the core does on its own when the peer's context is set up with
+ * el_config_t.auto_pong (or tools/el_bench_host.py on a PC). Each run
+ * sends a number of PINGs with one payload size and reports frames/s,
+ * goodput, RTT percentiles from a histogram, and the CPU cycles el_send
+ * spent per frame. Any transport works:
+ *
+ *   UART loopback   Jumper TX to RX (or enable the UART's internal
+ *                   loopback) and set auto_pong on the same context; the
+ *                   device answers its own PINGs.
+ *   UART or BLE     Run el_bench_host.py echo on the host, or another
+ *                   device with auto_pong.
+ *
+ * el_bench_core measures the protocol core alone, without a transport:
+ * cycles to encode and to parse one frame. In EL_CRC8_BENCH builds,
+ * el_bench_crc8 times every CRC-8 kernel in bytes per cycle, for choosing
+ * ETHERLINK_CRC8_IMPL on the target.
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#ifndef ETHERLINK_BENCH_H
+#define ETHERLINK_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "etherlink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EL_BENCH_MAX_WINDOW     32  // Upper bound for window
+#define EL_BENCH_HIST_BUCKETS   80  // RTT histogram: 4 buckets per octave, up to ~2 s
+
+/**
+ * Payload sizes used when el_bench_sweep is given no list
+ */
+#define EL_BENCH_DEFAULT_SIZES      { 0, 1, 16, 32, 64, 128, 200, 250 }
+#define EL_BENCH_DEFAULT_SIZE_COUNT 8
+
+/**
+ * Benchmark instance (opaque)
+ */
+typedef struct el_bench el_bench_t;
+
+/**
+ * How PINGs are issued
+ */
+typedef enum {
+    EL_BENCH_BURST = 0,         // Keep window PINGs in flight (throughput)
+    EL_BENCH_PACED,             // One PING every interval_us (latency under load)
+} el_bench_mode_t;
+
+/**
+ * Configuration for el_bench_create
+ */
+typedef struct {
+    el_ctx_t *ctx;              // Required: context the PINGs are sent on
+    el_bench_mode_t mode;
+    uint32_t frames;            // PINGs per run (0 = 1000)
+    uint8_t window;             // Burst: PINGs in flight (0 = 8, max EL_BENCH_MAX_WINDOW)
+    uint32_t interval_us;       // Paced: time between PINGs (0 = 10000), kept
+                                // on average; sends are woken on the RTOS tick
+    uint32_t timeout_ms;        // A PONG later than this counts as lost (0 = 1000)
+} el_bench_config_t;
+
+/**
+ * Result of one run
+ */
+typedef struct {
+    uint8_t payload_len;
+    uint32_t sent;              // PINGs el_send accepted
+    uint32_t refused;           // PINGs el_send refused (e.g. full TX ring)
+    uint32_t received;          // Matching PONGs
+    uint32_t lost;              // PONGs not seen within timeout_ms
+    uint32_t elapsed_us;
+    uint32_t frames_per_s;      // Round trips per second
+    uint32_t goodput_bps;       // Payload bytes per second, both directions
+    uint32_t rtt_min_us;
+    uint32_t rtt_p50_us;        // Percentiles are histogram bucket upper
+    uint32_t rtt_p99_us;        // bounds (within 25%)
+    uint32_t rtt_max_us;
+    uint32_t tx_cycles;         // CPU cycles per el_send, transport included
+} el_bench_result_t;
+
+/**
+ * Result of el_bench_core for one payload size
+ */
+typedef struct {
+    uint8_t payload_len;
+    uint32_t encode_cycles;     // el_send into a capturing transport
+    uint32_t decode_cycles;     // el_process_bytes of the same frame
+} el_bench_core_result_t;
+
+#if EL_CRC8_BENCH
+#define EL_BENCH_CRC8_SIZES         { 8, 64, 250, 1024 }
+#define EL_BENCH_CRC8_SIZE_COUNT    4
+#define EL_BENCH_CRC8_RESULTS       (EL_CRC8_KERNELS * EL_BENCH_CRC8_SIZE_COUNT)
+
+/**
+ * Result of el_bench_crc8 for one kernel and block size
+ */
+typedef struct {
+    uint8_t impl;               // EL_CRC8_TABLE, _SLICE4, _SLICE8 or _BITWISE
+    uint16_t len;               // Block size in bytes
+    uint32_t cycles;            // CPU cycles per el_crc8_kernel call
+    uint32_t milli_bytes_per_cycle; // Bytes per cycle x 1000
+} el_bench_crc8_result_t;
+#endif
+
+/**
+ * Create a benchmark instance
+ *
+ * PONGs must reach the instance: register el_bench_pong_handler for
+ * EL_MSG_PONG (user = the instance, min_len 0), or call el_bench_handle
+ * from on_message.
+ *
+ * @param config Configuration
+ * @param out Receives the instance
+ * @return ESP_OK on success
+ */
+esp_err_t el_bench_create(const el_bench_config_t *config, el_bench_t **out);
+
+/**
+ * Feed a received message to the benchmark
+ * @param bench Instance
+ * @param msg_id Message type identifier
+ * @param payload Payload data
+ * @param len Payload length
+ * @return true if msg_id is EL_MSG_PONG (consumed)
+ */
+bool el_bench_handle(el_bench_t *bench, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * el_handler_t adapter for el_register_handler (user = el_bench_t *)
+ */
+void el_bench_pong_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * Run one measurement with a fixed payload size
+ *
+ * Blocks the calling task until every PING is answered or timed out. The
+ * first two payload bytes carry a sequence number; 0- and 1-byte PINGs
+ * cannot, so they run one at a time whatever the window.
+ *
+ * @param bench Instance
+ * @param payload_len PING payload size (0 to EL_MAX_PAYLOAD)
+ * @param result Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if a run is already
+ *         going, ESP_ERR_TIMEOUT if no PONG came back at all
+ */
+esp_err_t el_bench_run(el_bench_t *bench, uint8_t payload_len, el_bench_result_t *result);
+
+/**
+ * Run one measurement per payload size
+ * @param bench Instance
+ * @param sizes Payload sizes, or NULL for EL_BENCH_DEFAULT_SIZES
+ * @param count Entries in sizes (ignored for NULL)
+ * @param results One per size (EL_BENCH_DEFAULT_SIZE_COUNT for NULL)
+ * @return ESP_OK if every run succeeded, else the first error
+ */
+esp_err_t el_bench_sweep(el_bench_t *bench, const uint8_t *sizes, size_t count,
+                         el_bench_result_t *results);
+
+/**
+ * RTT histogram of the last run
+ * @param bench Instance
+ * @return EL_BENCH_HIST_BUCKETS counts; bucket i holds RTTs from
+ *         el_bench_bucket_us(i) up to el_bench_bucket_us(i + 1) - 1
+ */
+const uint32_t *el_bench_histogram(const el_bench_t *bench);
+
+/**
+ * Lower bound of a histogram bucket in microseconds
+ */
+uint32_t el_bench_bucket_us(size_t index);
+
+/**
+ * Log results as a table, one line per run
+ */
+void el_bench_print(const el_bench_result_t *results, size_t count);
+
+/**
+ * Measure the protocol core without a transport
+ *
+ * Encodes and parses frames on a scratch context in the calling task
+ * (about 1 KB of stack). Not reentrant.
+ *
+ * @param sizes Payload sizes, or NULL for EL_BENCH_DEFAULT_SIZES
+ * @param count Entries in sizes (ignored for NULL)
+ * @param frames Frames per size (0 = 1000)
+ * @param results One per size (EL_BENCH_DEFAULT_SIZE_COUNT for NULL)
+ */
+void el_bench_core(const uint8_t *sizes, size_t count, uint32_t frames,
+                   el_bench_core_result_t *results);
+
+#if EL_CRC8_BENCH
+/**
+ * Time every CRC-8 kernel (EL_CRC8_BENCH builds)
+ *
+ * Runs el_crc8_kernel over EL_BENCH_CRC8_SIZES blocks in the calling task,
+ * which should sit alone on its core for steady numbers.
+ *
+ * @param iters Calls per kernel and size (0 = 1000)
+ * @param results EL_BENCH_CRC8_RESULTS entries, kernel by kernel
+ */
+void el_bench_crc8(uint32_t iters, el_bench_crc8_result_t *results);
+
+/**
+ * Log el_bench_crc8 results as a table
+ */
+void el_bench_crc8_print(const el_bench_crc8_result_t *results);
+#endif
+
+/**
+ * Free a benchmark instance (not while a run is going)
+ * @param bench Instance
+ * @return ESP_OK on success
+ */
+esp_err_t el_bench_delete(el_bench_t *bench);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERLINK_BENCH_H
@@ -0,0 +1,530 @@
+/**
+ * Etherlink Benchmark - Implementation
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink_bench.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "el_bench";
+
+#define DEFAULT_FRAMES          1000
+#define DEFAULT_WINDOW          8
+#define DEFAULT_INTERVAL_US     10000
+#define DEFAULT_TIMEOUT_MS      1000
+
+#define SEQ_LEN                 2       // Sequence number at the start of the payload
+
+// One PING waiting for its PONG
+typedef struct {
+    bool busy;
+    uint16_t seq;
+    uint32_t sent_us;
+} slot_t;
+
+struct el_bench {
+    el_bench_config_t cfg;
+
+    portMUX_TYPE lock;              // Guards everything below against the PONG handler
+    TaskHandle_t runner;            // Task inside el_bench_run (NULL when idle)
+    uint8_t payload_len;
+    uint8_t window;
+    slot_t slots[EL_BENCH_MAX_WINDOW];
+    uint8_t inflight;
+
+    uint32_t received;
+    uint32_t rtt_min_us;
+    uint32_t rtt_max_us;
+    uint32_t hist[EL_BENCH_HIST_BUCKETS];
+
+#if EL_STATIC_ALLOC
+    bool in_use;
+#endif
+};
+
+#if EL_STATIC_ALLOC
+static el_bench_t bench_instance;
+#endif
+
+static const uint8_t default_sizes[EL_BENCH_DEFAULT_SIZE_COUNT] = EL_BENCH_DEFAULT_SIZES;
+
+/*******************************************************************************
+ * Histogram
+ ******************************************************************************/
+
+// 0-3 us get a bucket each, then 4 buckets per power of two
+static size_t bucket_of(uint32_t us) {
+    if (us < 4) {
+        return us;
+    }
+    unsigned e = 31 - (unsigned)__builtin_clz(us);
+    size_t index = 4 * (e - 1) + ((us >> (e - 2)) & 3);
+    return index < EL_BENCH_HIST_BUCKETS ? index : EL_BENCH_HIST_BUCKETS - 1;
+}
+
+uint32_t el_bench_bucket_us(size_t index) {
+    if (index < 4) {
+        return (uint32_t)index;
+    }
+    unsigned e = (unsigned)(index / 4 + 1);
+    return (uint32_t)(4 + index % 4) << (e - 2);
+}
+
+// Smallest RTT bound that covers the given share of samples
+static uint32_t percentile(const el_bench_t *b, uint32_t per_mille) {
+    uint64_t want = ((uint64_t)b->received * per_mille + 999) / 1000;
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < EL_BENCH_HIST_BUCKETS; i++) {
+        seen += b->hist[i];
+        if (seen >= want && seen > 0) {
+            uint32_t upper = i + 1 < EL_BENCH_HIST_BUCKETS ? el_bench_bucket_us(i + 1) - 1
+                                                           : b->rtt_max_us;
+            return upper < b->rtt_max_us ? upper : b->rtt_max_us;
+        }
+    }
+    return b->rtt_max_us;
+}
+
+/*******************************************************************************
+ * PONG Handling
+ ******************************************************************************/
+
+bool el_bench_handle(el_bench_t *bench, uint8_t msg_id, const void *payload, uint8_t len) {
+    if (!bench || msg_id != EL_MSG_PONG) {
+        return false;
+    }
+
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    const uint8_t *p = payload;
+    TaskHandle_t wake = NULL;
+
+    portENTER_CRITICAL(&bench->lock);
+    if (bench->runner && len == bench->payload_len) {
+        // Short payloads run one at a time in slot 0
+        uint16_t seq = len >= SEQ_LEN ? (uint16_t)(p[0] | (p[1] << 8)) : bench->slots[0].seq;
+        slot_t *s = &bench->slots[seq % bench->window];
+
+        if (s->busy && s->seq == seq) {
+            uint32_t rtt = now - s->sent_us;
+            s->busy = false;
+            bench->inflight--;
+            bench->received++;
+            bench->hist[bucket_of(rtt)]++;
+            if (rtt < bench->rtt_min_us) {
+                bench->rtt_min_us = rtt;
+            }
+            if (rtt > bench->rtt_max_us) {
+                bench->rtt_max_us = rtt;
+            }
+            wake = bench->runner;
+        }
+    }
+    portEXIT_CRITICAL(&bench->lock);
+
+    // Late PONGs (already counted lost) and stray ones are dropped
+    if (wake) {
+        xTaskNotifyGive(wake);
+    }
+    return true;
+}
+
+void el_bench_pong_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len) {
+    el_bench_handle((el_bench_t *)user, msg_id, payload, len);
+}
+
+/*******************************************************************************
+ * Runs
+ ******************************************************************************/
+
+// Give up on PINGs older than the timeout; returns how many
+static uint32_t expire(el_bench_t *b, uint32_t now) {
+    uint32_t timeout_us = b->cfg.timeout_ms * 1000;
+    uint32_t lost = 0;
+
+    portENTER_CRITICAL(&b->lock);
+    for (size_t i = 0; i < b->window; i++) {
+        slot_t *s = &b->slots[i];
+        if (s->busy && now - s->sent_us >= timeout_us) {
+            s->busy = false;
+            b->inflight--;
+            lost++;
+        }
+    }
+    portEXIT_CRITICAL(&b->lock);
+    return lost;
+}
+
+static void wait_us(uint32_t us) {
+    TickType_t ticks = pdMS_TO_TICKS(us / 1000);
+    ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1);
+}
+
+esp_err_t el_bench_run(el_bench_t *bench, uint8_t payload_len, el_bench_result_t *result) {
+    if (!bench || !result || payload_len > EL_MAX_PAYLOAD) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    el_bench_t *b = bench;
+    el_ctx_t *ctx = b->cfg.ctx;
+    uint8_t window = payload_len < SEQ_LEN ? 1
+                   : b->cfg.mode == EL_BENCH_BURST ? b->cfg.window : EL_BENCH_MAX_WINDOW;
+    uint8_t payload[EL_MAX_PAYLOAD];
+
+    for (size_t i = SEQ_LEN; i < payload_len; i++) {
+        payload[i] = (uint8_t)(i * 37);
+    }
+
+    portENTER_CRITICAL(&b->lock);
+    if (b->runner) {
+        portEXIT_CRITICAL(&b->lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    memset(b->slots, 0, sizeof(b->slots));
+    memset(b->hist, 0, sizeof(b->hist));
+    b->payload_len = payload_len;
+    b->window = window;
+    b->inflight = 0;
+    b->received = 0;
+    b->rtt_min_us = UINT32_MAX;
+    b->rtt_max_us = 0;
+    b->runner = xTaskGetCurrentTaskHandle();
+    portEXIT_CRITICAL(&b->lock);
+
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    memset(result, 0, sizeof(*result));
+    result->payload_len = payload_len;
+
+    uint64_t cycles = 0;
+    uint16_t seq = 0;
+    uint32_t issued = 0;
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    uint32_t next_send = start;
+
+    while (issued < b->cfg.frames || b->inflight > 0) {
+        uint32_t now = (uint32_t)esp_timer_get_time();
+        result->lost += expire(b, now);
+
+        bool due = b->cfg.mode == EL_BENCH_BURST || (int32_t)(now - next_send) >= 0;
+        if (issued < b->cfg.frames && b->inflight < window && due) {
+            slot_t *s = &b->slots[seq % window];
+            if (s->busy) {
+                // Its PONG is overdue but not yet timed out
+                wait_us(1000);
+                continue;
+            }
+
+            if (payload_len >= SEQ_LEN) {
+                payload[0] = (uint8_t)seq;
+                payload[1] = (uint8_t)(seq >> 8);
+            }
+
+            // Armed before sending: the PONG can beat el_send's return
+            portENTER_CRITICAL(&b->lock);
+            s->seq = seq;
+            s->sent_us = (uint32_t)esp_timer_get_time();
+            s->busy = true;
+            b->inflight++;
+            portEXIT_CRITICAL(&b->lock);
+
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            bool ok = el_send(ctx, EL_MSG_PING, payload, payload_len);
+            cycles += esp_cpu_get_cycle_count() - c0;
+
+            if (ok) {
+                result->sent++;
+            } else {
+                result->refused++;
+                portENTER_CRITICAL(&b->lock);
+                if (s->busy && s->seq == seq) {
+                    s->busy = false;
+                    b->inflight--;
+                }
+                portEXIT_CRITICAL(&b->lock);
+            }
+
+            issued++;
+            seq++;
+            next_send += b->cfg.interval_us;
+
+            // Burst mode lets batching transports fill the window first
+            if (b->cfg.mode == EL_BENCH_PACED || b->inflight >= window || issued == b->cfg.frames) {
+                el_flush(ctx);
+            }
+            continue;
+        }
+
+        // Sleep until a PONG arrives, the next PING is due or a timeout
+        uint32_t sleep_us = b->cfg.timeout_ms * 1000;
+        if (issued < b->cfg.frames && b->cfg.mode == EL_BENCH_PACED && b->inflight < window) {
+            int32_t until = (int32_t)(next_send - now);
+            sleep_us = until > 0 ? (uint32_t)until : 0;
+        }
+        wait_us(sleep_us);
+    }
+
+    uint32_t elapsed = (uint32_t)esp_timer_get_time() - start;
+
+    portENTER_CRITICAL(&b->lock);
+    b->runner = NULL;
+    portEXIT_CRITICAL(&b->lock);
+
+    result->received = b->received;
+    result->elapsed_us = elapsed;
+    if (elapsed > 0) {
+        result->frames_per_s = (uint32_t)((uint64_t)b->received * 1000000 / elapsed);
+        result->goodput_bps = (uint32_t)((uint64_t)b->received * payload_len * 2 * 1000000 / elapsed);
+    }
+    if (b->received > 0) {
+        result->rtt_min_us = b->rtt_min_us;
+        result->rtt_p50_us = percentile(b, 500);
+        result->rtt_p99_us = percentile(b, 990);
+        result->rtt_max_us = b->rtt_max_us;
+    }
+    if (issued > 0) {
+        result->tx_cycles = (uint32_t)(cycles / issued);
+    }
+
+    return b->received > 0 || issued == 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t el_bench_sweep(el_bench_t *bench, const uint8_t *sizes, size_t count,
+                         el_bench_result_t *results) {
+    if (!bench || !results) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!sizes) {
+        sizes = default_sizes;
+        count = EL_BENCH_DEFAULT_SIZE_COUNT;
+    }
+
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < count; i++) {
+        esp_err_t err = el_bench_run(bench, sizes[i], &results[i]);
+        if (err != ESP_OK && ret == ESP_OK) {
+            ret = err;
+        }
+    }
+    return ret;
+}
+
+const uint32_t *el_bench_histogram(const el_bench_t *bench) {
+    return bench ? bench->hist : NULL;
+}
+
+void el_bench_print(const el_bench_result_t *results, size_t count) {
+    ESP_LOGI(TAG, " len   sent   lost  frames/s  goodput B/s  rtt min/p50/p99/max us   cycles");
+    for (size_t i = 0; i < count; i++) {
+        const el_bench_result_t *r = &results[i];
+        ESP_LOGI(TAG, "%4u %6lu %6lu %9lu %12lu  %lu/%lu/%lu/%lu %8lu",
+                 (unsigned)r->payload_len, (unsigned long)r->sent,
+                 (unsigned long)(r->lost + r->refused), (unsigned long)r->frames_per_s,
+                 (unsigned long)r->goodput_bps, (unsigned long)r->rtt_min_us,
+                 (unsigned long)r->rtt_p50_us, (unsigned long)r->rtt_p99_us,
+                 (unsigned long)r->rtt_max_us, (unsigned long)r->tx_cycles);
+    }
+}
+
+/*******************************************************************************
+ * Core Benchmark
+ ******************************************************************************/
+
+// Scratch transport: collects one encoded frame
+typedef struct {
+    uint8_t buf[EL_FRAME_OVERHEAD + EL_MAX_PAYLOAD];
+    size_t len;
+} capture_t;
+
+static volatile uint32_t core_delivered;
+
+static void capture_sendv(void *user, const el_iovec_t *iov, size_t iovcnt) {
+    capture_t *cap = user;
+    for (size_t i = 0; i < iovcnt; i++) {
+        if (cap->len + iov[i].len <= sizeof(cap->buf)) {
+            memcpy(&cap->buf[cap->len], iov[i].data, iov[i].len);
+            cap->len += iov[i].len;
+        }
+    }
+}
+
+static void core_on_message(uint8_t msg_id, const void *payload, uint8_t len) {
+    core_delivered++;
+}
+
+void el_bench_core(const uint8_t *sizes, size_t count, uint32_t frames,
+                   el_bench_core_result_t *results) {
+    if (!results) {
+        return;
+    }
+    if (!sizes) {
+        sizes = default_sizes;
+        count = EL_BENCH_DEFAULT_SIZE_COUNT;
+    }
+    if (frames == 0) {
+        frames = DEFAULT_FRAMES;
+    }
+
+    capture_t cap;
+    uint8_t payload[EL_MAX_PAYLOAD];
+    el_ctx_t ctx;
+    el_config_t config = {
+        .on_message = core_on_message,
+        .send_bytesv = capture_sendv,
+        .send_user = &cap,
+    };
+    el_init(&ctx, &config);
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t len = sizes[i] <= EL_MAX_PAYLOAD ? sizes[i] : EL_MAX_PAYLOAD;
+        uint64_t enc = 0;
+        uint64_t dec = 0;
+
+        for (size_t j = 0; j < len; j++) {
+            payload[j] = (uint8_t)(j * 37);
+        }
+        core_delivered = 0;
+
+        for (uint32_t n = 0; n < frames; n++) {
+            cap.len = 0;
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            el_send(&ctx, EL_MSG_PING, payload, len);
+            uint32_t c1 = esp_cpu_get_cycle_count();
+            el_process_bytes(&ctx, cap.buf, cap.len);
+            uint32_t c2 = esp_cpu_get_cycle_count();
+            enc += c1 - c0;
+            dec += c2 - c1;
+        }
+
+        if (core_delivered != frames) {
+            ESP_LOGW(TAG, "Core: %lu of %lu frames parsed at %u bytes",
+                     (unsigned long)core_delivered, (unsigned long)frames, (unsigned)len);
+        }
+        results[i].payload_len = len;
+        results[i].encode_cycles = (uint32_t)(enc / frames);
+        results[i].decode_cycles = (uint32_t)(dec / frames);
+    }
+}
+
+#if EL_CRC8_BENCH
+
+/*******************************************************************************
+ * CRC-8 Kernel Benchmark
+ ******************************************************************************/
+
+static const uint16_t crc8_sizes[EL_BENCH_CRC8_SIZE_COUNT] = EL_BENCH_CRC8_SIZES;
+static const char *const crc8_names[EL_CRC8_KERNELS] = { "table", "slice4", "slice8", "bitwise" };
+static uint8_t crc8_block[1024];
+
+void el_bench_crc8(uint32_t iters, el_bench_crc8_result_t *results) {
+    if (!results) {
+        return;
+    }
+    if (iters == 0) {
+        iters = DEFAULT_FRAMES;
+    }
+    for (size_t i = 0; i < sizeof(crc8_block); i++) {
+        crc8_block[i] = (uint8_t)(i * 37);
+    }
+
+    volatile uint8_t sink = 0;
+    for (int k = 0; k < EL_CRC8_KERNELS; k++) {
+        for (size_t i = 0; i < EL_BENCH_CRC8_SIZE_COUNT; i++) {
+            el_bench_crc8_result_t *r = &results[k * EL_BENCH_CRC8_SIZE_COUNT + i];
+            uint16_t len = crc8_sizes[i];
+            uint64_t total = 0;
+
+            for (uint32_t n = 0; n < iters; n++) {
+                uint32_t c0 = esp_cpu_get_cycle_count();
+                sink = el_crc8_kernel(k, crc8_block, len);
+                total += esp_cpu_get_cycle_count() - c0;
+            }
+
+            r->impl = (uint8_t)k;
+            r->len = len;
+            r->cycles = (uint32_t)(total / iters);
+            r->milli_bytes_per_cycle = r->cycles ? (uint32_t)(len * 1000ull / r->cycles) : 0;
+        }
+    }
+    (void)sink;
+}
+
+void el_bench_crc8_print(const el_bench_crc8_result_t *results) {
+    ESP_LOGI(TAG, "kernel    len    cycles  B/cycle");
+    for (size_t i = 0; i < EL_BENCH_CRC8_RESULTS; i++) {
+        const el_bench_crc8_result_t *r = &results[i];
+        ESP_LOGI(TAG, "%-7s %5u %9lu  %lu.%03lu", crc8_names[r->impl], (unsigned)r->len,
+                 (unsigned long)r->cycles, (unsigned long)(r->milli_bytes_per_cycle / 1000),
+                 (unsigned long)(r->milli_bytes_per_cycle % 1000));
+    }
+}
+
+#endif // EL_CRC8_BENCH
+
+/*******************************************************************************
+ * Lifecycle
+ ******************************************************************************/
+
+esp_err_t el_bench_create(const el_bench_config_t *config, el_bench_t **out) {
+    if (!config || !config->ctx || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->window > EL_BENCH_MAX_WINDOW) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if EL_STATIC_ALLOC
+    if (bench_instance.in_use) {
+        return ESP_ERR_NO_MEM;
+    }
+    el_bench_t *b = &bench_instance;
+    memset(b, 0, sizeof(*b));
+    b->in_use = true;
+#else
+    el_bench_t *b = calloc(1, sizeof(*b));
+    if (!b) {
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+
+    b->cfg = *config;
+    if (b->cfg.frames == 0) {
+        b->cfg.frames = DEFAULT_FRAMES;
+    }
+    if (b->cfg.window == 0) {
+        b->cfg.window = DEFAULT_WINDOW;
+    }
+    if (b->cfg.interval_us == 0) {
+        b->cfg.interval_us = DEFAULT_INTERVAL_US;
+    }
+    if (b->cfg.timeout_ms == 0) {
+        b->cfg.timeout_ms = DEFAULT_TIMEOUT_MS;
+    }
+    portMUX_INITIALIZE(&b->lock);
+
+    *out = b;
+    return ESP_OK;
+}
+
+esp_err_t el_bench_delete(el_bench_t *bench) {
+    if (!bench) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (bench->runner) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+#if EL_STATIC_ALLOC
+    bench->in_use = false;
+#else
+    free(bench);
+#endif
+    return ESP_OK;
+}
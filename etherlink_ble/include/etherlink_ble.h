@@ -14,7 +14,9 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
 #include "etherlink.h"
+#include "etherlink_dispatch.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,19 +27,171 @@ extern "C" {
  */
 typedef void (*el_ble_raw_rx_cb_t)(const uint8_t *data, size_t len);
 
+/**
+ * Per-connection state (pass as user to el_ble_send_rawv to address a peer)
+ */
+typedef struct el_ble_conn_s el_ble_conn_t;
+
 /**
  * Connection event callback type
  */
 typedef void (*el_ble_event_cb_t)(void);
 
+#define EL_BLE_MAX_CONN         4   // Upper bound for max_connections
+#define EL_BLE_FRAG_HIST_SIZE   8   // Notifications-per-send histogram buckets
+
+/**
+ * TX statistics
+ *
+ * A "send" is one frame, or one batch when coalescing. Sends larger than
+ * MTU-3 bytes are split across several notifications.
+ */
+typedef struct {
+    uint32_t sends;             // Sends completed
+    uint32_t notifications;     // Notifications issued for those sends
+    uint32_t max_notifications; // Most notifications a single send needed
+    uint32_t notify_hist[EL_BLE_FRAG_HIST_SIZE]; // [n-1]: sends needing n
+                                // notifications (last bucket: n or more)
+    uint32_t enomem_retries;    // Backoffs on BLE_HS_ENOMEM
+    uint32_t tx_failures;       // Sends abandoned (out of buffers or error)
+    uint32_t queue_drops;       // Frames a subscriber missed because its
+                                // TX queue was full
+    uint32_t queue_high_water;  // Most frames any subscriber's TX queue held
+
+    // mbufs (pool fields are zero without a dedicated pool)
+    uint32_t mbuf_alloc_failures; // Notification mbufs that could not be built
+    uint16_t mbuf_pool_total;   // Buffers in the dedicated pool
+    uint16_t mbuf_pool_free;    // Free right now
+    uint16_t mbuf_pool_min_free; // Low-water mark since init
+} el_ble_stats_t;
+
+#define EL_BLE_FRAME_HDR        16  // Upper bound for a fan-out frame header
+#define EL_BLE_MBUF_OVERHEAD    (4 * sizeof(void *) + 8) // struct os_mbuf + packet header
+
+/**
+ * Dedicated mbuf pool memory for count buffers of size data bytes
+ */
+#define EL_BLE_MBUF_BLOCK(size)             ((((size) + 3) & ~3u) + EL_BLE_MBUF_OVERHEAD)
+#define EL_BLE_MBUF_POOL_BYTES(count, size) ((count) * EL_BLE_MBUF_BLOCK(size))
+
+/**
+ * Reserve a dedicated mbuf pool at link time (el_ble_config_t.mbuf_mem)
+ */
+#define EL_BLE_MBUF_POOL_DEFINE(name, count, size) \
+    static uint32_t name[EL_BLE_MBUF_POOL_BYTES(count, size) / sizeof(uint32_t)]
+
+/**
+ * Fan-out pool block for frames of up to frame_size bytes
+ */
+#define EL_BLE_FRAME_BLOCK(frame_size) \
+    ((EL_BLE_FRAME_HDR + (frame_size) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *))
+
+/**
+ * Subscriber queue memory for the given connections and queue length
+ */
+#define EL_BLE_TXQ_BYTES(conns, queue_len)  ((conns) * (queue_len) * sizeof(void *))
+
+/**
+ * Caller-owned memory for EL_STATIC_ALLOC builds
+ *
+ * Reserve it with EL_BLE_STORAGE_DEFINE. task_stack_size replaces
+ * tx_task_stack_size in el_ble_config_t. The fan-out fields are needed
+ * only with tx_queue_len > 0; frames are then taken from a fixed pool
+ * instead of the heap, and a frame longer than frame_size fails to queue.
+ */
+typedef struct {
+    StackType_t *tx_task_stack;     // Contexts with a TX ring
+    StackType_t *fanout_task_stack; // tx_queue_len > 0
+    uint32_t task_stack_size;       // Bytes, for each stack above
+    uint8_t *txq_buf;               // EL_BLE_TXQ_BYTES(max_connections, tx_queue_len)
+    uint8_t *frame_pool;            // frame_count * EL_BLE_FRAME_BLOCK(frame_size) bytes
+    uint16_t frame_count;           // Frames in flight across all subscribers
+    uint16_t frame_size;            // Largest frame fanned out
+} el_ble_storage_t;
+
+/**
+ * Reserve BLE storage at link time
+ *
+ * Pass queue_len = 0 (and frames = 0) without fan-out queues.
+ *
+ *   EL_BLE_STORAGE_DEFINE(ble_mem, 3072, 2, 8, 8, EL_MAX_PAYLOAD + EL_FRAME_OVERHEAD);
+ */
+#define EL_BLE_STORAGE_DEFINE(name, stack, conns, queue_len, frames, frame_bytes)    \
+    static StackType_t name##_tx_stack[(stack) / sizeof(StackType_t)];             \
+    static StackType_t name##_fanout_stack[(queue_len) ? (stack) / sizeof(StackType_t) : 0]; \
+    static uint8_t name##_txq[EL_BLE_TXQ_BYTES(conns, queue_len)]                   \
+        __attribute__((aligned(sizeof(void *))));                                   \
+    static uint8_t name##_frames[(frames) * EL_BLE_FRAME_BLOCK(frame_bytes)]        \
+        __attribute__((aligned(sizeof(void *))));                                   \
+    static const el_ble_storage_t name = {                                          \
+        .tx_task_stack = name##_tx_stack,                                           \
+        .fanout_task_stack = (queue_len) ? name##_fanout_stack : NULL,              \
+        .task_stack_size = (stack),                                                 \
+        .txq_buf = name##_txq,                                                      \
+        .frame_pool = name##_frames, .frame_count = (frames),                       \
+        .frame_size = (frame_bytes),                                                \
+    }
+
+/**
+ * Connection profile: interval, latency, PHY and data length requested
+ * from the central
+ *
+ * INTERFERENCE_SAFE keeps the radio quiet with a 200-400 ms interval on
+ * the 1M PHY, so it does not disturb timing-critical signals such as
+ * DShot telemetry. LOWPOWER uses a 100-200 ms interval and lets the
+ * peripheral skip up to 4 idle events. BULK asks for a 7.5-15 ms
+ * interval, the 2M PHY and 251-byte link-layer PDUs (DLE) for transfers.
+ */
+typedef enum {
+    EL_BLE_PROFILE_INTERFERENCE_SAFE = 0,
+    EL_BLE_PROFILE_LOWPOWER,
+    EL_BLE_PROFILE_BULK,
+} el_ble_profile_t;
+
 /**
  * Configuration for Etherlink BLE transport
  */
 typedef struct {
     const char *device_name;    // BLE device name (max 29 chars)
     el_ctx_t *protocol_ctx;     // Etherlink protocol context (auto-wires RX)
+    el_dispatch_t *dispatch;    // Optional: decode in this dispatcher's task
+                                // instead of the NimBLE host task
     el_ble_event_cb_t on_connect;    // Called on BLE connection (optional)
     el_ble_event_cb_t on_disconnect; // Called on BLE disconnect (optional)
+    uint16_t coalesce_ms;       // Batch frames into one notification for up to
+                                // this long (0 = off, send each frame at once)
+
+    // Connection profile
+    el_ble_profile_t profile;   // Requested on connect (default INTERFERENCE_SAFE)
+    uint16_t auto_bulk_idle_ms; // Switch to BULK while the reliable channel
+                                // (or an OTA transfer on it) is busy, and back
+                                // after this long without traffic (0 = off)
+
+    // Multiple centrals. NimBLE must also allow them
+    // (CONFIG_BT_NIMBLE_MAX_CONNECTIONS).
+    uint8_t max_connections;    // Concurrent connections (0 = 1, max EL_BLE_MAX_CONN)
+    el_ctx_t *const *peer_ctxs; // Optional: one context per connection slot
+                                // (max_connections entries), so each peer
+                                // gets its own parser and replies
+    uint8_t tx_queue_len;       // Frames queued per subscriber (0 = notify
+                                // every peer in turn from the sending task)
+
+    // Sender tasks (TX ring drain and fan-out)
+    uint32_t tx_task_stack_size; // Stack in bytes (0 = 3072)
+    uint8_t tx_task_priority;   // Priority (0 = 5)
+    bool task_pinned;           // Pin them to task_core (default: no affinity)
+    int task_core;              // Core for the sender tasks when task_pinned
+
+    // Dedicated TX mbuf pool, so bursts of notifications do not compete
+    // with the host for the shared msys buffers (mbuf_count 0 = use msys)
+    uint16_t mbuf_count;        // Buffers in the pool
+    uint16_t mbuf_size;         // Data bytes per buffer (0 = 256); a larger
+                                // notification chains several buffers
+    void *mbuf_mem;             // Optional: EL_BLE_MBUF_POOL_BYTES(mbuf_count,
+                                // mbuf_size) bytes, 4-aligned (NULL = allocate;
+                                // required with EL_STATIC_ALLOC)
+
+    const el_ble_storage_t *storage; // Required with EL_STATIC_ALLOC, ignored otherwise
 } el_ble_config_t;
 
 /**
@@ -52,6 +206,43 @@ typedef struct {
  * passed to el_process_bytes(). You still need to set send_bytes
  * callback in the protocol config to el_ble_send_raw().
  *
+ * With coalesce_ms set, outgoing frames are packed back to back into a
+ * single notification of up to MTU-3 bytes. A batch goes out when the
+ * next frame would not fit, when coalesce_ms expires after its first
+ * frame, or on el_ble_flush() / el_flush(). The receiver's parser splits
+ * the frames again on EL_SYNC_BYTE, so the peer needs no changes.
+ *
+ * If protocol_ctx was initialized with a TX ring, a sender task drains it
+ * and packs the queued frames into MTU-sized notifications; coalesce_ms is
+ * not needed in that mode.
+ *
+ * With max_connections > 1, advertising continues until every slot is
+ * taken. Frames sent through protocol_ctx go to every connected peer.
+ * Data written by a peer is parsed by peer_ctxs[slot] when given, which is
+ * bound with el_bind_transport() so its replies reach only that peer;
+ * without peer_ctxs all peers share protocol_ctx's parser, which is only
+ * safe if a single peer writes.
+ *
+ * Each notification is built by copying the frame's header, payload and
+ * CRC segments straight into one mbuf. With mbuf_count set, the mbufs come
+ * from a dedicated pool and the blocks for a whole notification are
+ * checked for before it is built, so a burst backs off cleanly instead of
+ * failing halfway.
+ *
+ * Broadcast frames only go to peers that enabled notifications. With
+ * tx_queue_len set, each frame is copied once into a shared buffer and
+ * queued to every subscriber; a sender task feeds the peers round robin.
+ * A subscriber whose queue is full misses that frame (counted in
+ * queue_drops) instead of holding up the others.
+ * Replies from peer_ctxs take the same queue, behind the broadcasts
+ * already waiting for that peer.
+ *
+ * Each new connection is asked for the parameters of config->profile. With
+ * auto_bulk_idle_ms set, the reliable channels on protocol_ctx and
+ * peer_ctxs are watched every 100 ms: traffic on them switches every
+ * connection to EL_BLE_PROFILE_BULK, and auto_bulk_idle_ms without any
+ * switches back to the selected profile.
+ *
  * @param config Configuration
  * @return ESP_OK on success
  */
@@ -65,43 +256,114 @@ esp_err_t el_ble_init(const el_ble_config_t *config);
 void el_ble_send_raw(const uint8_t *data, size_t len);
 
 /**
- * Send data to connected BLE client
+ * Send a frame from segments over BLE (use as send_bytesv callback)
+ *
+ * The segments are appended to a single mbuf chain and sent as one
+ * notification, so the frame is never staged in a flat buffer.
+ *
+ * @param user Connection to send to, or NULL for every connected peer
+ * @param iov Segments to send
+ * @param iovcnt Number of segments
+ */
+void el_ble_send_rawv(void *user, const el_iovec_t *iov, size_t iovcnt);
+
+/**
+ * Send data to every connected BLE client
+ *
+ * Data longer than MTU-3 bytes is split across several notifications.
+ * If NimBLE is out of buffers the call backs off and retries for a few
+ * ticks before giving up. From the NimBLE host task (a handler without a
+ * dispatcher), and for coalesced batches, it gives up at once instead;
+ * set tx_queue_len to have the sender task wait it out.
+ *
  * @param data Data to send
- * @param len Length of data (max ~240 bytes per call, MTU dependent)
- * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not connected
+ * @param len Length of data
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not connected,
+ *         ESP_ERR_NO_MEM if buffers stayed exhausted
  */
 esp_err_t el_ble_send(const uint8_t *data, size_t len);
 
+/**
+ * Send any batched frames now (no-op unless coalesce_ms is set)
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not connected
+ */
+esp_err_t el_ble_flush(void);
+
+/**
+ * Flush batched frames (use as flush callback in el_config_t)
+ * @param user Unused
+ */
+void el_ble_flush_raw(void *user);
+
 /**
  * Check if a client is connected
- * @return true if connected
+ * @return true if at least one client is connected
  */
 bool el_ble_is_connected(void);
 
 /**
- * Get current MTU size
+ * Get the number of connected clients
+ * @return Connection count
+ */
+size_t el_ble_get_conn_count(void);
+
+/**
+ * Get current MTU size (smallest across connections)
  * @return MTU size (default 23, can be up to 517 after negotiation)
  */
 uint16_t el_ble_get_mtu(void);
 
 /**
- * Get RSSI of current connection
+ * Get TX statistics
+ * @param stats Filled with a snapshot of the counters
+ */
+void el_ble_get_stats(el_ble_stats_t *stats);
+
+/**
+ * Reset TX statistics
+ */
+void el_ble_reset_stats(void);
+
+/**
+ * Get RSSI of the first connection
  * @return RSSI in dBm (-127 to +20), or 127 if not connected/error
  */
 int8_t el_ble_get_rssi(void);
 
+/**
+ * Select the connection profile
+ *
+ * Requests the profile's parameters on every open connection and on later
+ * ones. The central has the final say: it may pick other values within the
+ * range, or refuse the 2M PHY or DLE. While automatic bulk mode is active
+ * the new profile takes effect when it ends.
+ *
+ * @param profile Profile to use
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown profile, or
+ *         ESP_FAIL if a request to an open connection failed
+ */
+esp_err_t el_ble_set_profile(el_ble_profile_t profile);
+
+/**
+ * Get the profile currently requested (EL_BLE_PROFILE_BULK during
+ * automatic bulk mode)
+ */
+el_ble_profile_t el_ble_get_profile(void);
+
 /**
  * Set raw RX callback for transparent bridge mode
  *
  * When set, received BLE data is passed to this callback in addition to
  * (or instead of) the protocol parser. Useful for transparent bridges.
+ * A long write is delivered as several calls, one per mbuf segment, in
+ * order.
  *
  * @param cb Callback function, or NULL to disable
  */
 void el_ble_set_raw_rx_callback(el_ble_raw_rx_cb_t cb);
 
 /**
- * Force disconnect from current BLE client
+ * Force disconnect from all BLE clients
  *
  * Useful for recovering from stale connections. After disconnect,
  * advertising will automatically restart.
@@ -7,7 +7,13 @@
  */
 
 #include "etherlink_ble.h"
+#include "etherlink_reliable.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "nvs_flash.h"
 #include "esp_nimble_hci.h"
 #include "nimble/nimble_port.h"
@@ -16,6 +22,7 @@
 #include "host/util/util.h"
 #include "services/gap/ble_svc_gap.h"
 #include "services/gatt/ble_svc_gatt.h"
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "el_ble";
@@ -37,12 +44,105 @@ static const ble_uuid128_t nus_tx_uuid =
     BLE_UUID128_INIT(0x9e, 0xca, 0xdc, 0x24, 0x0e, 0xe5, 0xa9, 0xe0,
                      0x93, 0xf3, 0xa3, 0xb5, 0x03, 0x00, 0x40, 0x6e);
 
+#define BLE_DEFAULT_MTU     23
+
+// Frame shared by every subscriber queue it was fanned out to
+typedef struct ble_frame_s {
+    uint32_t refs;              // Queues (and senders) still holding it
+    uint16_t len;
+#if EL_STATIC_ALLOC
+    struct ble_frame_s *next;   // Free list link while in the pool
+#endif
+    uint8_t data[];
+} ble_frame_t;
+
+_Static_assert(sizeof(ble_frame_t) <= EL_BLE_FRAME_HDR, "update EL_BLE_FRAME_HDR");
+
+// Per-connection state
+struct el_ble_conn_s {
+    uint16_t handle;            // BLE_HS_CONN_HANDLE_NONE when the slot is free
+    uint16_t mtu;
+    bool subscribed;            // Peer enabled notifications on the TX char
+    el_ctx_t *ctx;              // Parser for data written by this peer
+
+    // Fan-out queue (tx_queue_len > 0)
+    QueueHandle_t txq;          // ble_frame_t * waiting for this peer
+    ble_frame_t *cur;           // Frame being sent
+    uint16_t cur_off;           // Bytes of cur already notified
+    uint8_t cur_notifications;
+    uint8_t cur_retries;
+};
+
 static uint16_t nus_tx_handle;
-static uint16_t conn_handle = BLE_HS_CONN_HANDLE_NONE;
-static uint16_t current_mtu = 23;
+static el_ble_conn_t conns[EL_BLE_MAX_CONN];
+static size_t max_conns = 1;
 static el_ctx_t *protocol_ctx = NULL;
+static el_dispatch_t *dispatch = NULL;
 static uint8_t own_addr_type;
 
+// TX coalescing (ATT notification payload is MTU - 3, MTU max 517)
+#define BLE_ATT_HDR_SIZE    3
+#define BLE_MAX_NOTIFY_LEN  (517 - BLE_ATT_HDR_SIZE)
+
+static uint16_t coalesce_ms = 0;
+static uint8_t tx_batch[BLE_MAX_NOTIFY_LEN];
+static size_t tx_batch_len = 0;
+static SemaphoreHandle_t tx_batch_lock = NULL;
+static esp_timer_handle_t tx_batch_timer = NULL;
+
+// Fragmentation / backpressure
+#define BLE_TX_RETRY_LIMIT  20      // BLE_HS_ENOMEM retries per notification
+
+// Updated from the sending tasks, the fan-out task and the batch timer,
+// so only through stat_add / stat_max
+static el_ble_stats_t tx_stats;
+
+// Dedicated TX mbuf pool (mbuf_count > 0)
+#define MBUF_DEFAULT_SIZE   256
+#define MBUF_LEADING        11      // HCI ACL + L2CAP + ATT notify headers,
+                                    // as reserved by ble_hs_mbuf_att_pkt
+
+static struct os_mempool tx_mempool;
+static struct os_mbuf_pool tx_mbuf_pool;
+static uint16_t tx_mbuf_size = 0;   // Data bytes per buffer (0 = no pool, use msys)
+
+// Asynchronous TX sender task
+#define TX_TASK_STACK_SIZE  3072
+#define TX_TASK_PRIORITY    5
+
+static uint32_t tx_task_stack_size = TX_TASK_STACK_SIZE;
+static UBaseType_t tx_task_priority = TX_TASK_PRIORITY;
+static BaseType_t tx_task_core = tskNO_AFFINITY;
+static TaskHandle_t tx_task_handle = NULL;
+static TaskHandle_t host_task_handle = NULL;
+
+// Fan-out sender task
+static uint8_t tx_queue_len = 0;
+static TaskHandle_t fanout_task_handle = NULL;
+static SemaphoreHandle_t fanout_lock = NULL;
+
+#if EL_STATIC_ALLOC
+// Control blocks and the fan-out frame pool; buffers come from storage
+static const el_ble_storage_t *storage = NULL;
+static StaticTask_t tx_task_buf;
+static StaticTask_t fanout_task_buf;
+static StaticSemaphore_t fanout_lock_buf;
+static StaticSemaphore_t tx_batch_lock_buf;
+static StaticQueue_t txq_bufs[EL_BLE_MAX_CONN];
+static portMUX_TYPE frame_pool_mux = portMUX_INITIALIZER_UNLOCKED;
+static ble_frame_t *frame_free_list = NULL;
+#endif
+
+// Connection profiles
+#define AUTO_BULK_POLL_MS   100
+
+static volatile el_ble_profile_t base_profile = EL_BLE_PROFILE_INTERFERENCE_SAFE;
+static volatile bool auto_bulk_active = false;
+static uint16_t auto_bulk_idle_ms = 0;
+static esp_timer_handle_t auto_bulk_timer = NULL;
+static uint32_t auto_bulk_activity = 0;     // Last sum of channel counters
+static int64_t auto_bulk_busy_us = 0;       // When that sum last changed
+
 // Callbacks
 static el_ble_raw_rx_cb_t raw_rx_callback = NULL;
 static el_ble_event_cb_t on_connect_cb = NULL;
@@ -52,6 +152,8 @@ static el_ble_event_cb_t on_disconnect_cb = NULL;
 static int nus_chr_access(uint16_t conn_handle, uint16_t attr_handle,
                           struct ble_gatt_access_ctxt *ctxt, void *arg);
 static void el_ble_advertise(void);
+static void tx_batch_timer_cb(void *arg);
+static void fanout_drain(el_ble_conn_t *c);
 
 // GATT service definition
 static const struct ble_gatt_svc_def nus_svcs[] = {
@@ -78,26 +180,179 @@ static const struct ble_gatt_svc_def nus_svcs[] = {
     { 0 }, // Terminator
 };
 
+/*******************************************************************************
+ * Connections
+ ******************************************************************************/
+
+static el_ble_conn_t *conn_find(uint16_t handle) {
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle == handle) {
+            return &conns[i];
+        }
+    }
+    return NULL;
+}
+
+static size_t conn_count(void) {
+    size_t n = 0;
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle != BLE_HS_CONN_HANDLE_NONE) {
+            n++;
+        }
+    }
+    return n;
+}
+
+// Largest notification every connected peer accepts (0 if none connected)
+static size_t broadcast_limit(void) {
+    size_t limit = 0;
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle != BLE_HS_CONN_HANDLE_NONE) {
+            size_t n = conns[i].mtu - BLE_ATT_HDR_SIZE;
+            if (limit == 0 || n < limit) {
+                limit = n;
+            }
+        }
+    }
+    return limit;
+}
+
+/*******************************************************************************
+ * Connection Profiles
+ ******************************************************************************/
+
+typedef struct {
+    uint16_t itvl_min;          // Units of 1.25 ms
+    uint16_t itvl_max;
+    uint16_t latency;           // Connection events the peripheral may skip
+    uint16_t timeout;           // Supervision timeout, units of 10 ms
+    uint8_t phy_mask;           // BLE_GAP_LE_PHY_*_MASK, both directions
+    uint16_t tx_octets;         // Link-layer PDU payload (27 = no DLE)
+    uint16_t tx_time;           // Matching air time in us on the 1M PHY
+} profile_params_t;
+
+static const profile_params_t profiles[] = {
+    [EL_BLE_PROFILE_INTERFERENCE_SAFE] = { 160, 320, 0, 500, BLE_GAP_LE_PHY_1M_MASK, 27, 328 },
+    [EL_BLE_PROFILE_LOWPOWER] = { 80, 160, 4, 600, BLE_GAP_LE_PHY_1M_MASK, 27, 328 },
+    [EL_BLE_PROFILE_BULK] = { 6, 12, 0, 400,
+                              BLE_GAP_LE_PHY_1M_MASK | BLE_GAP_LE_PHY_2M_MASK, 251, 2120 },
+};
+
+static const char *const profile_names[] = {
+    [EL_BLE_PROFILE_INTERFERENCE_SAFE] = "interference-safe",
+    [EL_BLE_PROFILE_LOWPOWER] = "low-power",
+    [EL_BLE_PROFILE_BULK] = "bulk",
+};
+
+static el_ble_profile_t active_profile(void) {
+    return auto_bulk_active ? EL_BLE_PROFILE_BULK : base_profile;
+}
+
+// Ask the central for a profile's parameters; it decides what it grants
+static int profile_request(uint16_t handle, el_ble_profile_t profile) {
+    const profile_params_t *p = &profiles[profile];
+
+    struct ble_gap_upd_params conn_params = {
+        .itvl_min = p->itvl_min,
+        .itvl_max = p->itvl_max,
+        .latency = p->latency,
+        .supervision_timeout = p->timeout,
+    };
+    int rc = ble_gap_update_params(handle, &conn_params);
+
+    // PHY and data length are best effort: older centrals lack both
+    int prc = ble_gap_set_prefered_le_phy(handle, p->phy_mask, p->phy_mask, BLE_GAP_LE_PHY_CODED_ANY);
+    int drc = ble_gap_set_data_len(handle, p->tx_octets, p->tx_time);
+    if (prc != 0 || drc != 0) {
+        ESP_LOGD(TAG, "PHY/DLE request refused, handle=%d: %d/%d", handle, prc, drc);
+    }
+
+    ESP_LOGI(TAG, "Requested %s profile, handle=%d (%u-%u ms)", profile_names[profile], handle,
+             (unsigned)(p->itvl_min * 5 / 4), (unsigned)(p->itvl_max * 5 / 4));
+    return rc;
+}
+
+static esp_err_t profile_request_all(el_ble_profile_t profile) {
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle == BLE_HS_CONN_HANDLE_NONE) {
+            continue;
+        }
+        int rc = profile_request(conns[i].handle, profile);
+        if (rc != 0) {
+            ESP_LOGW(TAG, "Parameter update failed, handle=%d: %d", conns[i].handle, rc);
+            ret = ESP_FAIL;
+        }
+    }
+    return ret;
+}
+
+// Sum of counters that move whenever a reliable channel carries data
+static uint32_t rel_activity(void) {
+    uint32_t sum = 0;
+    el_ctx_t *prev = NULL;
+
+    for (size_t i = 0; i <= max_conns; i++) {
+        el_ctx_t *ctx = i < max_conns ? conns[i].ctx : protocol_ctx;
+        if (!ctx || ctx == prev || !ctx->reliable) {
+            continue;
+        }
+        prev = ctx;
+        const el_rel_t *rel = ctx->reliable;
+        sum += rel->tx_frames + rel->tx_retransmits + rel->rx_delivered + rel->rx_duplicates +
+               rel->acks_received;
+    }
+    return sum;
+}
+
+static void auto_bulk_timer_cb(void *arg) {
+    uint32_t activity = rel_activity();
+    int64_t now = esp_timer_get_time();
+
+    if (activity != auto_bulk_activity) {
+        auto_bulk_activity = activity;
+        auto_bulk_busy_us = now;
+        if (!auto_bulk_active && conn_count() > 0) {
+            auto_bulk_active = true;
+            if (base_profile != EL_BLE_PROFILE_BULK) {
+                profile_request_all(EL_BLE_PROFILE_BULK);
+            }
+        }
+    } else if (auto_bulk_active && now - auto_bulk_busy_us >= (int64_t)auto_bulk_idle_ms * 1000) {
+        auto_bulk_active = false;
+        if (base_profile != EL_BLE_PROFILE_BULK) {
+            profile_request_all(base_profile);
+        }
+    }
+}
+
+/*******************************************************************************
+ * GATT and GAP Events
+ ******************************************************************************/
+
 static int nus_chr_access(uint16_t conn_handle, uint16_t attr_handle,
                           struct ble_gatt_access_ctxt *ctxt, void *arg) {
     if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
-        // Data received from client
-        uint16_t len = OS_MBUF_PKTLEN(ctxt->om);
-        uint8_t buf[512];
-
-        if (len > sizeof(buf)) {
-            len = sizeof(buf);
-        }
+        // Data received from client. A long write arrives as a chain of
+        // mbufs, and each segment is handed over in place. The parser
+        // carries frames across calls, so nothing is flattened or truncated.
+        el_ble_conn_t *c = conn_find(conn_handle);
+        el_ctx_t *ctx = c ? c->ctx : protocol_ctx;
 
-        int rc = ble_hs_mbuf_to_flat(ctxt->om, buf, len, NULL);
-        if (rc == 0) {
+        for (const struct os_mbuf *om = ctxt->om; om; om = SLIST_NEXT(om, om_next)) {
+            if (om->om_len == 0) {
+                continue;
+            }
             // Call raw callback first (for transparent bridges)
             if (raw_rx_callback) {
-                raw_rx_callback(buf, len);
+                raw_rx_callback(om->om_data, om->om_len);
             }
-            // Then parse via protocol if configured
-            if (protocol_ctx) {
-                el_process_bytes(protocol_ctx, buf, len);
+            // Then parse via protocol if configured (in the dispatcher
+            // task when one is attached, so handlers can't stall the host)
+            if (ctx && dispatch) {
+                el_dispatch_push_ctx(dispatch, ctx, om->om_data, om->om_len);
+            } else if (ctx) {
+                el_process_bytes(ctx, om->om_data, om->om_len);
             }
         }
     }
@@ -105,40 +360,65 @@ static int nus_chr_access(uint16_t conn_handle, uint16_t attr_handle,
 }
 
 static int ble_gap_event(struct ble_gap_event *event, void *arg) {
+    el_ble_conn_t *c;
+
     switch (event->type) {
         case BLE_GAP_EVENT_CONNECT:
             if (event->connect.status == 0) {
-                conn_handle = event->connect.conn_handle;
-                ESP_LOGI(TAG, "Connected, handle=%d - advertising STOPPED", conn_handle);
-
-                // Request longer connection interval to reduce BLE radio interference
-                // with DShot telemetry. Use 200-400ms interval (units of 1.25ms)
-                struct ble_gap_upd_params conn_params = {
-                    .itvl_min = 160,  // 200ms (160 * 1.25ms)
-                    .itvl_max = 320,  // 400ms (320 * 1.25ms)
-                    .latency = 0,
-                    .supervision_timeout = 500,  // 5 seconds
-                };
-                ble_gap_update_params(conn_handle, &conn_params);
-                ESP_LOGI(TAG, "Requested longer connection interval (200-400ms)");
+                uint16_t conn_handle = event->connect.conn_handle;
+                c = conn_find(BLE_HS_CONN_HANDLE_NONE);
+                if (!c) {
+                    ESP_LOGW(TAG, "No free connection slot, rejecting handle=%d", conn_handle);
+                    ble_gap_terminate(conn_handle, BLE_ERR_CONN_LIMIT);
+                    break;
+                }
+                c->handle = conn_handle;
+                c->mtu = BLE_DEFAULT_MTU;
+                ESP_LOGI(TAG, "Connected, handle=%d (%u/%u)", conn_handle,
+                         (unsigned)conn_count(), (unsigned)max_conns);
+
+                // Interference-safe by default (200-400 ms, keeps clear of
+                // DShot telemetry); bulk while a transfer is running
+                profile_request(conn_handle, active_profile());
 
                 // Call connection callback
                 if (on_connect_cb) {
                     on_connect_cb();
                 }
+
+                // Advertising stops on connect; keep accepting centrals
+                // until every slot is taken
+                if (conn_count() < max_conns) {
+                    el_ble_advertise();
+                }
             } else {
-                conn_handle = BLE_HS_CONN_HANDLE_NONE;
                 el_ble_advertise();
             }
             break;
 
         case BLE_GAP_EVENT_DISCONNECT:
-            ESP_LOGI(TAG, "Disconnected, reason=%d", event->disconnect.reason);
-            conn_handle = BLE_HS_CONN_HANDLE_NONE;
-            current_mtu = 23;
-            // Reset protocol parser on disconnect
-            if (protocol_ctx) {
-                el_reset(protocol_ctx);
+            ESP_LOGI(TAG, "Disconnected, handle=%d reason=%d",
+                     event->disconnect.conn.conn_handle, event->disconnect.reason);
+            c = conn_find(event->disconnect.conn.conn_handle);
+            if (!c) {
+                break;
+            }
+            c->handle = BLE_HS_CONN_HANDLE_NONE;
+            c->mtu = BLE_DEFAULT_MTU;
+            c->subscribed = false;
+            fanout_drain(c);
+            // Drop anything batched once the last peer is gone
+            if (tx_batch_lock && conn_count() == 0) {
+                xSemaphoreTake(tx_batch_lock, portMAX_DELAY);
+                tx_batch_len = 0;
+                esp_timer_stop(tx_batch_timer);
+                xSemaphoreGive(tx_batch_lock);
+            }
+            // Reset this peer's protocol parser
+            if (c->ctx && dispatch) {
+                el_dispatch_reset_ctx(dispatch, c->ctx);
+            } else if (c->ctx) {
+                el_reset(c->ctx);
             }
             // Call disconnect callback
             if (on_disconnect_cb) {
@@ -148,8 +428,46 @@ static int ble_gap_event(struct ble_gap_event *event, void *arg) {
             break;
 
         case BLE_GAP_EVENT_MTU:
-            current_mtu = event->mtu.value;
-            ESP_LOGI(TAG, "MTU updated to %d", current_mtu);
+            c = conn_find(event->mtu.conn_handle);
+            if (c) {
+                // NimBLE allows up to 527; tx_batch holds one 517-byte MTU
+                c->mtu = event->mtu.value < BLE_MAX_NOTIFY_LEN + BLE_ATT_HDR_SIZE
+                             ? event->mtu.value : BLE_MAX_NOTIFY_LEN + BLE_ATT_HDR_SIZE;
+                ESP_LOGI(TAG, "MTU updated to %d, handle=%d", c->mtu, c->handle);
+            }
+            break;
+
+        case BLE_GAP_EVENT_CONN_UPDATE: {
+            struct ble_gap_conn_desc desc;
+            if (event->conn_update.status == 0 &&
+                ble_gap_conn_find(event->conn_update.conn_handle, &desc) == 0) {
+                ESP_LOGI(TAG, "Connection interval %u.%02u ms, latency %u, handle=%d",
+                         (unsigned)(desc.conn_itvl * 5 / 4), (unsigned)(desc.conn_itvl * 125 % 100),
+                         (unsigned)desc.conn_latency, desc.conn_handle);
+            } else if (event->conn_update.status != 0) {
+                ESP_LOGW(TAG, "Parameter update rejected, handle=%d: %d",
+                         event->conn_update.conn_handle, event->conn_update.status);
+            }
+            break;
+        }
+
+        case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+            if (event->phy_updated.status == 0) {
+                ESP_LOGI(TAG, "PHY TX %uM RX %uM, handle=%d", (unsigned)event->phy_updated.tx_phy,
+                         (unsigned)event->phy_updated.rx_phy, event->phy_updated.conn_handle);
+            }
+            break;
+
+        case BLE_GAP_EVENT_SUBSCRIBE:
+            c = conn_find(event->subscribe.conn_handle);
+            if (c && event->subscribe.attr_handle == nus_tx_handle) {
+                c->subscribed = event->subscribe.cur_notify;
+                ESP_LOGI(TAG, "Notifications %s, handle=%d",
+                         c->subscribed ? "enabled" : "disabled", c->handle);
+                if (!c->subscribed) {
+                    fanout_drain(c);
+                }
+            }
             break;
 
         case BLE_GAP_EVENT_ADV_COMPLETE:
@@ -215,6 +533,556 @@ static void el_ble_advertise(void) {
     }
 }
 
+/*******************************************************************************
+ * Fragmentation
+ ******************************************************************************/
+
+_Static_assert(sizeof(struct os_mbuf) + sizeof(struct os_mbuf_pkthdr) <= EL_BLE_MBUF_OVERHEAD,
+               "update EL_BLE_MBUF_OVERHEAD");
+
+static esp_err_t mbuf_pool_init(const el_ble_config_t *config) {
+    uint16_t size = config->mbuf_size ? config->mbuf_size : MBUF_DEFAULT_SIZE;
+    uint32_t block = EL_BLE_MBUF_BLOCK(size);
+    void *mem = config->mbuf_mem;
+
+#if !EL_STATIC_ALLOC
+    // With EL_STATIC_ALLOC, el_ble_init has checked that mbuf_mem is set
+    if (!mem) {
+        mem = malloc(EL_BLE_MBUF_POOL_BYTES(config->mbuf_count, size));
+        if (!mem) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+#endif
+
+    int rc = os_mempool_init(&tx_mempool, config->mbuf_count, block, mem, "el_ble_tx");
+    if (rc == 0) {
+        rc = os_mbuf_pool_init(&tx_mbuf_pool, &tx_mempool, block, config->mbuf_count);
+    }
+    if (rc != 0) {
+        ESP_LOGE(TAG, "Failed to set up mbuf pool: %d", rc);
+        return ESP_FAIL;
+    }
+
+    tx_mbuf_size = size;
+    return ESP_OK;
+}
+
+// Empty notification mbuf with room for the lower-layer headers in front
+static struct os_mbuf *mbuf_get(size_t len) {
+    if (tx_mbuf_size == 0) {
+        return ble_hs_mbuf_att_pkt();
+    }
+
+    // Take the whole notification's blocks or none; appending into a pool
+    // that runs dry halfway would waste the blocks already filled
+    size_t blocks = (MBUF_LEADING + len + tx_mbuf_size - 1) / tx_mbuf_size;
+    if (tx_mempool.mp_num_free < blocks) {
+        return NULL;
+    }
+
+    struct os_mbuf *om = os_mbuf_get_pkthdr(&tx_mbuf_pool, 0);
+    if (om) {
+        om->om_data += MBUF_LEADING;
+    }
+    return om;
+}
+
+static void stat_add(uint32_t *counter, uint32_t n) {
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static void stat_max(uint32_t *mark, uint32_t value) {
+    uint32_t cur = __atomic_load_n(mark, __ATOMIC_RELAXED);
+    while (value > cur &&
+           !__atomic_compare_exchange_n(mark, &cur, value, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Build an mbuf holding bytes [off, off + len) of the concatenated segments.
+// The frame's header, payload and CRC are copied straight in; this is the
+// only copy on the way to the radio.
+static struct os_mbuf *mbuf_from_segments(const el_iovec_t *iov, size_t iovcnt,
+                                          size_t off, size_t len) {
+    struct os_mbuf *om = mbuf_get(len);
+    if (!om) {
+        stat_add(&tx_stats.mbuf_alloc_failures, 1);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < iovcnt && len > 0; i++) {
+        if (off >= iov[i].len) {
+            off -= iov[i].len;
+            continue;
+        }
+
+        size_t n = iov[i].len - off;
+        if (n > len) {
+            n = len;
+        }
+
+        if (os_mbuf_append(om, (const uint8_t *)iov[i].data + off, n) != 0) {
+            os_mbuf_free_chain(om);
+            stat_add(&tx_stats.mbuf_alloc_failures, 1);
+            return NULL;
+        }
+        off = 0;
+        len -= n;
+    }
+
+    return om;
+}
+
+static void record_send(size_t notifications) {
+    stat_add(&tx_stats.sends, 1);
+    stat_add(&tx_stats.notifications, (uint32_t)notifications);
+    stat_max(&tx_stats.max_notifications, (uint32_t)notifications);
+    size_t bucket = notifications < EL_BLE_FRAG_HIST_SIZE
+                        ? notifications - 1 : EL_BLE_FRAG_HIST_SIZE - 1;
+    stat_add(&tx_stats.notify_hist[bucket], 1);
+}
+
+// ENOMEM backoff sleeps, which the NimBLE host task must not do: the
+// buffers it waits for are freed by that same task
+static bool tx_may_wait(void) {
+    return xTaskGetCurrentTaskHandle() != host_task_handle;
+}
+
+// Send segments to one peer as one or more notifications of at most
+// MTU - 3 bytes. When NimBLE runs out of buffers, back off a tick and
+// retry the fragment if may_wait, else fail at once.
+static esp_err_t notify_conn(el_ble_conn_t *c, const el_iovec_t *iov, size_t iovcnt,
+                             bool may_wait) {
+    uint16_t conn_handle = c->handle;
+    if (conn_handle == BLE_HS_CONN_HANDLE_NONE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    size_t limit = c->mtu - BLE_ATT_HDR_SIZE;
+    size_t notifications = 0;
+    esp_err_t ret = ESP_OK;
+
+    for (size_t sent = 0; sent < total; ) {
+        size_t chunk = total - sent < limit ? total - sent : limit;
+        int retries = 0;
+        int rc;
+
+        while (1) {
+            // notify_custom consumes the mbuf even on failure, so rebuild each try
+            struct os_mbuf *om = mbuf_from_segments(iov, iovcnt, sent, chunk);
+            rc = om ? ble_gatts_notify_custom(conn_handle, nus_tx_handle, om)
+                    : BLE_HS_ENOMEM;
+            if (rc != BLE_HS_ENOMEM || !may_wait || retries >= BLE_TX_RETRY_LIMIT ||
+                c->handle != conn_handle) {
+                break;
+            }
+            retries++;
+            stat_add(&tx_stats.enomem_retries, 1);
+            vTaskDelay(1);
+        }
+
+        if (rc != 0) {
+            stat_add(&tx_stats.tx_failures, 1);
+            ret = rc == BLE_HS_ENOMEM ? ESP_ERR_NO_MEM : ESP_FAIL;
+            break;
+        }
+
+        notifications++;
+        sent += chunk;
+    }
+
+    if (notifications > 0) {
+        record_send(notifications);
+    }
+
+    return ret;
+}
+
+static esp_err_t fanout_enqueue(el_ble_conn_t *target, const el_iovec_t *iov, size_t iovcnt);
+
+// Send segments to every subscribed peer
+static esp_err_t notify_segments(const el_iovec_t *iov, size_t iovcnt, bool may_wait) {
+    if (tx_queue_len > 0) {
+        return fanout_enqueue(NULL, iov, iovcnt);
+    }
+
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle == BLE_HS_CONN_HANDLE_NONE || !conns[i].subscribed) {
+            continue;
+        }
+        esp_err_t err = notify_conn(&conns[i], iov, iovcnt, may_wait);
+        if (ret == ESP_OK || ret == ESP_ERR_INVALID_STATE) {
+            ret = err;
+        }
+    }
+
+    return ret;
+}
+
+static esp_err_t notify_flat(const uint8_t *data, size_t len, bool may_wait) {
+    el_iovec_t seg = { .data = data, .len = len };
+    return notify_segments(&seg, 1, may_wait);
+}
+
+/*******************************************************************************
+ * Fan-out
+ ******************************************************************************/
+
+// Each frame is encoded once into a shared, reference-counted buffer and
+// queued to every subscriber. The sender task walks the connections round
+// robin, one notification per peer per pass, so a peer that stalls (out of
+// buffers, long connection interval) only backs up its own queue. The
+// per-peer mbuf is built from the shared buffer at notify time, since
+// NimBLE consumes an mbuf on every notify.
+
+static ble_frame_t *frame_alloc(size_t len) {
+#if EL_STATIC_ALLOC
+    if (len > storage->frame_size) {
+        return NULL;
+    }
+    portENTER_CRITICAL(&frame_pool_mux);
+    ble_frame_t *f = frame_free_list;
+    if (f) {
+        frame_free_list = f->next;
+    }
+    portEXIT_CRITICAL(&frame_pool_mux);
+    return f;
+#else
+    return malloc(sizeof(ble_frame_t) + len);
+#endif
+}
+
+static void frame_release(ble_frame_t *f) {
+    if (f && __atomic_sub_fetch(&f->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+#if EL_STATIC_ALLOC
+        portENTER_CRITICAL(&frame_pool_mux);
+        f->next = frame_free_list;
+        frame_free_list = f;
+        portEXIT_CRITICAL(&frame_pool_mux);
+#else
+        free(f);
+#endif
+    }
+}
+
+// Caller holds fanout_lock (or the sender task is not running yet)
+static void fanout_drain_locked(el_ble_conn_t *c) {
+    ble_frame_t *f;
+
+    frame_release(c->cur);
+    c->cur = NULL;
+    while (c->txq && xQueueReceive(c->txq, &f, 0) == pdTRUE) {
+        frame_release(f);
+    }
+}
+
+static void fanout_drain(el_ble_conn_t *c) {
+    if (!fanout_lock) {
+        return;
+    }
+    xSemaphoreTake(fanout_lock, portMAX_DELAY);
+    fanout_drain_locked(c);
+    xSemaphoreGive(fanout_lock);
+}
+
+// Queue a copy of the segments to target, or to every subscriber if NULL
+static esp_err_t fanout_enqueue(el_ble_conn_t *target, const el_iovec_t *iov, size_t iovcnt) {
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    ble_frame_t *f = frame_alloc(total);
+    if (!f) {
+        stat_add(&tx_stats.tx_failures, 1);
+        return ESP_ERR_NO_MEM;
+    }
+
+    f->refs = 1;                // Held by this function until queued
+    f->len = total;
+    size_t off = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        memcpy(&f->data[off], iov[i].data, iov[i].len);
+        off += iov[i].len;
+    }
+
+    size_t queued = 0;
+    xSemaphoreTake(fanout_lock, portMAX_DELAY);
+    for (size_t i = 0; i < max_conns; i++) {
+        el_ble_conn_t *c = &conns[i];
+        if ((target && c != target) || c->handle == BLE_HS_CONN_HANDLE_NONE || !c->subscribed) {
+            continue;
+        }
+        __atomic_add_fetch(&f->refs, 1, __ATOMIC_RELAXED);
+        if (xQueueSend(c->txq, &f, 0) == pdTRUE) {
+            queued++;
+            stat_max(&tx_stats.queue_high_water, (uint32_t)uxQueueMessagesWaiting(c->txq));
+        } else {
+            // This peer is not keeping up; it loses the frame, others don't
+            __atomic_sub_fetch(&f->refs, 1, __ATOMIC_RELAXED);
+            stat_add(&tx_stats.queue_drops, 1);
+        }
+    }
+    xSemaphoreGive(fanout_lock);
+
+    frame_release(f);
+    if (queued > 0) {
+        xTaskNotifyGive(fanout_task_handle);
+        return ESP_OK;
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+// Send the next notification for one peer. Caller holds fanout_lock.
+// Returns true if the peer has more to send; *stalled is set on ENOMEM.
+static bool fanout_step(el_ble_conn_t *c, bool *stalled) {
+    if (c->handle == BLE_HS_CONN_HANDLE_NONE) {
+        return false;
+    }
+
+    if (!c->cur) {
+        if (xQueueReceive(c->txq, &c->cur, 0) != pdTRUE) {
+            return false;
+        }
+        c->cur_off = 0;
+        c->cur_notifications = 0;
+        c->cur_retries = 0;
+    }
+
+    ble_frame_t *f = c->cur;
+    size_t limit = c->mtu - BLE_ATT_HDR_SIZE;
+    size_t remaining = f->len - c->cur_off;
+    size_t chunk = remaining < limit ? remaining : limit;
+    el_iovec_t seg = { .data = &f->data[c->cur_off], .len = chunk };
+
+    struct os_mbuf *om = mbuf_from_segments(&seg, 1, 0, chunk);
+    int rc = om ? ble_gatts_notify_custom(c->handle, nus_tx_handle, om) : BLE_HS_ENOMEM;
+
+    if (rc == 0) {
+        c->cur_off += chunk;
+        c->cur_notifications++;
+        if (c->cur_off < f->len) {
+            return true;
+        }
+        record_send(c->cur_notifications);
+    } else if (rc == BLE_HS_ENOMEM && c->cur_retries < BLE_TX_RETRY_LIMIT) {
+        c->cur_retries++;
+        stat_add(&tx_stats.enomem_retries, 1);
+        *stalled = true;
+        return true;
+    } else {
+        stat_add(&tx_stats.tx_failures, 1);
+    }
+
+    frame_release(f);
+    c->cur = NULL;
+    return uxQueueMessagesWaiting(c->txq) > 0;
+}
+
+static void ble_fanout_task(void *arg) {
+    ESP_LOGI(TAG, "BLE fan-out task started");
+
+    bool more = false;
+    while (1) {
+        if (!more) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+
+        bool stalled = false;
+        more = false;
+        xSemaphoreTake(fanout_lock, portMAX_DELAY);
+        for (size_t i = 0; i < max_conns; i++) {
+            more |= fanout_step(&conns[i], &stalled);
+        }
+        xSemaphoreGive(fanout_lock);
+
+        if (stalled) {
+            // Out of ACL buffers; let the controller drain before retrying
+            vTaskDelay(1);
+        }
+    }
+}
+
+// stack/tcb are used with EL_STATIC_ALLOC only
+static BaseType_t task_create(TaskFunction_t fn, const char *name,
+                              StackType_t *stack, StaticTask_t *tcb, TaskHandle_t *out) {
+#if EL_STATIC_ALLOC
+    if (!stack) {
+        return pdFAIL;
+    }
+    *out = xTaskCreateStaticPinnedToCore(fn, name, tx_task_stack_size, NULL, tx_task_priority,
+                                         stack, tcb, tx_task_core);
+    return *out ? pdPASS : pdFAIL;
+#else
+    return xTaskCreatePinnedToCore(fn, name, tx_task_stack_size, NULL, tx_task_priority,
+                                   out, tx_task_core);
+#endif
+}
+
+static esp_err_t fanout_init(void) {
+#if EL_STATIC_ALLOC
+    if (!storage->txq_buf || !storage->frame_pool || !storage->frame_count) {
+        ESP_LOGE(TAG, "EL_STATIC_ALLOC: storage has no fan-out queues or frame pool");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t stride = EL_BLE_FRAME_BLOCK(storage->frame_size);
+    frame_free_list = NULL;
+    for (size_t i = 0; i < storage->frame_count; i++) {
+        ble_frame_t *f = (ble_frame_t *)&storage->frame_pool[i * stride];
+        f->next = frame_free_list;
+        frame_free_list = f;
+    }
+
+    fanout_lock = xSemaphoreCreateMutexStatic(&fanout_lock_buf);
+#else
+    fanout_lock = xSemaphoreCreateMutex();
+#endif
+    if (!fanout_lock) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (size_t i = 0; i < max_conns; i++) {
+#if EL_STATIC_ALLOC
+        uint8_t *slots = &storage->txq_buf[i * tx_queue_len * sizeof(ble_frame_t *)];
+        conns[i].txq = xQueueCreateStatic(tx_queue_len, sizeof(ble_frame_t *), slots,
+                                          &txq_bufs[i]);
+#else
+        conns[i].txq = xQueueCreate(tx_queue_len, sizeof(ble_frame_t *));
+#endif
+        if (!conns[i].txq) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    StackType_t *stack = NULL;
+    StaticTask_t *tcb = NULL;
+#if EL_STATIC_ALLOC
+    stack = storage->fanout_task_stack;
+    tcb = &fanout_task_buf;
+#endif
+    BaseType_t task_ret = task_create(ble_fanout_task, "el_ble_fanout", stack, tcb,
+                                      &fanout_task_handle);
+    return task_ret == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+/*******************************************************************************
+ * TX Coalescing
+ ******************************************************************************/
+
+// Caller holds tx_batch_lock, so a notification NimBLE has no buffer for
+// fails at once rather than sleeping with the lock held
+static esp_err_t batch_flush_locked(void) {
+    esp_timer_stop(tx_batch_timer);
+
+    if (tx_batch_len == 0) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = notify_flat(tx_batch, tx_batch_len, false);
+    tx_batch_len = 0;
+    return ret;
+}
+
+static void tx_batch_timer_cb(void *arg) {
+    xSemaphoreTake(tx_batch_lock, portMAX_DELAY);
+    batch_flush_locked();
+    xSemaphoreGive(tx_batch_lock);
+}
+
+// Append one frame (given as segments) to the batch, flushing as needed
+static esp_err_t batch_append(const el_iovec_t *iov, size_t iovcnt) {
+    size_t limit = broadcast_limit();
+    if (limit == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    size_t len = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        len += iov[i].len;
+    }
+
+    esp_err_t ret = ESP_OK;
+
+    xSemaphoreTake(tx_batch_lock, portMAX_DELAY);
+
+    if (tx_batch_len + len > limit) {
+        ret = batch_flush_locked();
+    }
+
+    if (len > limit) {
+        // Larger than one notification, fragment it on its own
+        ret = notify_segments(iov, iovcnt, false);
+    } else {
+        bool was_empty = tx_batch_len == 0;
+        for (size_t i = 0; i < iovcnt; i++) {
+            memcpy(&tx_batch[tx_batch_len], iov[i].data, iov[i].len);
+            tx_batch_len += iov[i].len;
+        }
+
+        if (tx_batch_len == limit) {
+            ret = batch_flush_locked();
+        } else if (was_empty) {
+            esp_timer_start_once(tx_batch_timer, (uint64_t)coalesce_ms * 1000);
+        }
+    }
+
+    xSemaphoreGive(tx_batch_lock);
+    return ret;
+}
+
+/*******************************************************************************
+ * Asynchronous TX
+ ******************************************************************************/
+
+// Drains the protocol context's TX ring. A claim usually holds several
+// frames, which notify_segments packs into MTU-sized notifications.
+static void ble_tx_task(void *arg) {
+    ESP_LOGI(TAG, "BLE TX task started");
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        el_iovec_t span[2];
+        size_t count;
+        while (el_tx_claim(protocol_ctx, span, &count) > 0) {
+            // Not connected: frames are discarded
+            notify_segments(span, count, true);
+            el_tx_release(protocol_ctx);
+        }
+    }
+}
+
+// Link part of el_get_stats for every context this transport serves
+static void ble_stats_hook(void *user, el_stats_t *stats) {
+    stats->link_tx_drops = tx_stats.queue_drops + tx_stats.tx_failures;
+    stats->link_queue_high_water = tx_stats.queue_high_water;
+    if (dispatch) {
+        el_dispatch_stats_t ds;
+        el_dispatch_get_stats(dispatch, &ds);
+        stats->link_rx_drops = ds.overflows;
+        if (tx_queue_len == 0) {
+            stats->link_queue_high_water = ds.high_water;
+        }
+    }
+}
+
+static void ble_tx_notify(void *user) {
+    xTaskNotifyGive((TaskHandle_t)user);
+}
+
+static void ble_tx_wait(void *user) {
+    vTaskDelay(1);
+}
+
 static void ble_on_reset(int reason) {
     ESP_LOGE(TAG, "BLE reset, reason=%d", reason);
 }
@@ -241,6 +1109,7 @@ static void ble_on_sync(void) {
 }
 
 static void ble_host_task(void *param) {
+    host_task_handle = xTaskGetCurrentTaskHandle();
     ESP_LOGI(TAG, "BLE host task started");
     nimble_port_run();
     nimble_port_freertos_deinit();
@@ -254,10 +1123,123 @@ esp_err_t el_ble_init(const el_ble_config_t *config) {
     // Suppress verbose NimBLE logging
     esp_log_level_set("NimBLE", ESP_LOG_ERROR);
 
+    size_t max = config->max_connections ? config->max_connections : 1;
+    if (max > EL_BLE_MAX_CONN) {
+        ESP_LOGE(TAG, "max_connections %u exceeds EL_BLE_MAX_CONN", (unsigned)max);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if ((unsigned)config->profile > EL_BLE_PROFILE_BULK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if EL_STATIC_ALLOC
+    if (!config->storage) {
+        ESP_LOGE(TAG, "EL_STATIC_ALLOC: config->storage is required");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->mbuf_count > 0 && !config->mbuf_mem) {
+        ESP_LOGE(TAG, "EL_STATIC_ALLOC: mbuf_mem is required with mbuf_count");
+        return ESP_ERR_INVALID_ARG;
+    }
+#endif
+
     // Save configuration
+    max_conns = max;
+    for (size_t i = 0; i < EL_BLE_MAX_CONN; i++) {
+        conns[i].handle = BLE_HS_CONN_HANDLE_NONE;
+        conns[i].mtu = BLE_DEFAULT_MTU;
+        conns[i].ctx = i < max && config->peer_ctxs ? config->peer_ctxs[i]
+                                                    : config->protocol_ctx;
+        // Replies from a peer's context go back to that peer only
+        if (i < max && config->peer_ctxs && conns[i].ctx) {
+            el_bind_transport(conns[i].ctx, el_ble_send_rawv, NULL, &conns[i]);
+        }
+        if (i < max && conns[i].ctx) {
+            el_set_stats_hook(conns[i].ctx, ble_stats_hook, NULL);
+        }
+    }
     protocol_ctx = config->protocol_ctx;
+    if (protocol_ctx) {
+        el_set_stats_hook(protocol_ctx, ble_stats_hook, NULL);
+    }
+    dispatch = config->dispatch;
+    tx_queue_len = config->tx_queue_len;
     on_connect_cb = config->on_connect;
     on_disconnect_cb = config->on_disconnect;
+    coalesce_ms = config->coalesce_ms;
+    base_profile = config->profile;
+    auto_bulk_idle_ms = config->auto_bulk_idle_ms;
+    tx_task_stack_size = config->tx_task_stack_size ? config->tx_task_stack_size : TX_TASK_STACK_SIZE;
+    tx_task_priority = config->tx_task_priority ? config->tx_task_priority : TX_TASK_PRIORITY;
+    tx_task_core = config->task_pinned ? (BaseType_t)config->task_core : tskNO_AFFINITY;
+
+#if EL_STATIC_ALLOC
+    storage = config->storage;
+    tx_task_stack_size = storage->task_stack_size;
+#endif
+
+    // Set by this call, so undone if a later step fails
+    bool made_batch = false;
+    bool made_bulk = false;
+    esp_err_t err = ESP_OK;
+
+    if (coalesce_ms > 0 && !tx_batch_lock) {
+#if EL_STATIC_ALLOC
+        tx_batch_lock = xSemaphoreCreateMutexStatic(&tx_batch_lock_buf);
+#else
+        tx_batch_lock = xSemaphoreCreateMutex();
+#endif
+        if (!tx_batch_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+
+        const esp_timer_create_args_t timer_args = {
+            .callback = tx_batch_timer_cb,
+            .name = "el_ble_batch",
+        };
+        err = esp_timer_create(&timer_args, &tx_batch_timer);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create batch timer: %s", esp_err_to_name(err));
+            vSemaphoreDelete(tx_batch_lock);
+            tx_batch_lock = NULL;
+            return err;
+        }
+        made_batch = true;
+    }
+
+    if (auto_bulk_idle_ms > 0 && !auto_bulk_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = auto_bulk_timer_cb,
+            .name = "el_ble_bulk",
+        };
+        err = esp_timer_create(&timer_args, &auto_bulk_timer);
+        if (err == ESP_OK) {
+            made_bulk = true;
+            err = esp_timer_start_periodic(auto_bulk_timer, AUTO_BULK_POLL_MS * 1000);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start bulk timer: %s", esp_err_to_name(err));
+        }
+    }
+
+    if (err == ESP_OK && config->mbuf_count > 0 && tx_mbuf_size == 0) {
+        err = mbuf_pool_init(config);
+    }
+
+    if (err != ESP_OK) {
+        if (made_bulk) {
+            esp_timer_stop(auto_bulk_timer);
+            esp_timer_delete(auto_bulk_timer);
+            auto_bulk_timer = NULL;
+        }
+        if (made_batch) {
+            esp_timer_delete(tx_batch_timer);
+            tx_batch_timer = NULL;
+            vSemaphoreDelete(tx_batch_lock);
+            tx_batch_lock = NULL;
+        }
+        return err;
+    }
 
     // Initialize NVS (required for BLE)
     esp_err_t ret = nvs_flash_init();
@@ -302,6 +1284,31 @@ esp_err_t el_ble_init(const el_ble_config_t *config) {
         return ESP_FAIL;
     }
 
+    // Per-subscriber TX queues
+    if (tx_queue_len > 0 && !fanout_task_handle) {
+        ret = fanout_init();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set up TX queues: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+    // Asynchronous TX: drain the context's TX ring from a sender task
+    if (protocol_ctx && el_tx_async(protocol_ctx) && !tx_task_handle) {
+        StackType_t *stack = NULL;
+        StaticTask_t *tcb = NULL;
+#if EL_STATIC_ALLOC
+        stack = storage->tx_task_stack;
+        tcb = &tx_task_buf;
+#endif
+        BaseType_t task_ret = task_create(ble_tx_task, "el_ble_tx", stack, tcb, &tx_task_handle);
+        if (task_ret != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create TX task");
+            return ESP_FAIL;
+        }
+        el_tx_attach(protocol_ctx, ble_tx_notify, ble_tx_wait, tx_task_handle);
+    }
+
     // Start host task
     nimble_port_freertos_init(ble_host_task);
 
@@ -313,53 +1320,125 @@ void el_ble_send_raw(const uint8_t *data, size_t len) {
     el_ble_send(data, len);
 }
 
-esp_err_t el_ble_send(const uint8_t *data, size_t len) {
-    if (conn_handle == BLE_HS_CONN_HANDLE_NONE) {
-        return ESP_ERR_INVALID_STATE;
+void el_ble_send_rawv(void *user, const el_iovec_t *iov, size_t iovcnt) {
+    if (user && tx_queue_len > 0) {
+        // Behind frames already queued to the peer; the fan-out task owns
+        // its cur / cur_off
+        fanout_enqueue(user, iov, iovcnt);
+    } else if (user) {
+        // Directed at one peer; coalescing only batches broadcasts
+        notify_conn(user, iov, iovcnt, tx_may_wait());
+    } else if (coalesce_ms > 0) {
+        batch_append(iov, iovcnt);
+    } else {
+        notify_segments(iov, iovcnt, tx_may_wait());
     }
+}
 
-    struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
-    if (!om) {
-        return ESP_ERR_NO_MEM;
+esp_err_t el_ble_send(const uint8_t *data, size_t len) {
+    if (coalesce_ms > 0) {
+        el_iovec_t seg = { .data = data, .len = len };
+        return batch_append(&seg, 1);
     }
 
-    int rc = ble_gatts_notify_custom(conn_handle, nus_tx_handle, om);
-    if (rc != 0) {
-        return ESP_FAIL;
+    return notify_flat(data, len, tx_may_wait());
+}
+
+esp_err_t el_ble_flush(void) {
+    if (conn_count() == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (coalesce_ms == 0) {
+        return ESP_OK;
     }
 
-    return ESP_OK;
+    xSemaphoreTake(tx_batch_lock, portMAX_DELAY);
+    esp_err_t ret = batch_flush_locked();
+    xSemaphoreGive(tx_batch_lock);
+    return ret;
+}
+
+void el_ble_flush_raw(void *user) {
+    (void)user;
+    el_ble_flush();
 }
 
 bool el_ble_is_connected(void) {
-    return conn_handle != BLE_HS_CONN_HANDLE_NONE;
+    return conn_count() > 0;
+}
+
+size_t el_ble_get_conn_count(void) {
+    return conn_count();
 }
 
 uint16_t el_ble_get_mtu(void) {
-    return current_mtu;
+    size_t limit = broadcast_limit();
+    return limit ? limit + BLE_ATT_HDR_SIZE : BLE_DEFAULT_MTU;
+}
+
+void el_ble_get_stats(el_ble_stats_t *stats) {
+    if (stats) {
+        *stats = tx_stats;
+        if (tx_mbuf_size > 0) {
+            stats->mbuf_pool_total = tx_mempool.mp_num_blocks;
+            stats->mbuf_pool_free = tx_mempool.mp_num_free;
+            stats->mbuf_pool_min_free = tx_mempool.mp_min_free;
+        }
+    }
+}
+
+void el_ble_reset_stats(void) {
+    memset(&tx_stats, 0, sizeof(tx_stats));
 }
 
 int8_t el_ble_get_rssi(void) {
     int8_t rssi = 127;  // Invalid value
-    if (conn_handle != BLE_HS_CONN_HANDLE_NONE) {
-        ble_gap_conn_rssi(conn_handle, &rssi);
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle != BLE_HS_CONN_HANDLE_NONE) {
+            ble_gap_conn_rssi(conns[i].handle, &rssi);
+            break;
+        }
     }
     return rssi;
 }
 
+esp_err_t el_ble_set_profile(el_ble_profile_t profile) {
+    if ((unsigned)profile > EL_BLE_PROFILE_BULK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    base_profile = profile;
+    if (auto_bulk_active) {
+        // Applied when the transfer ends
+        return ESP_OK;
+    }
+    return profile_request_all(profile);
+}
+
+el_ble_profile_t el_ble_get_profile(void) {
+    return active_profile();
+}
+
 void el_ble_set_raw_rx_callback(el_ble_raw_rx_cb_t cb) {
     raw_rx_callback = cb;
 }
 
 esp_err_t el_ble_disconnect(void) {
-    if (conn_handle == BLE_HS_CONN_HANDLE_NONE) {
+    if (conn_count() == 0) {
         return ESP_ERR_INVALID_STATE;
     }
-    int rc = ble_gap_terminate(conn_handle, BLE_ERR_REM_USER_CONN_TERM);
-    if (rc != 0) {
-        ESP_LOGE(TAG, "Failed to terminate connection: %d", rc);
-        return ESP_FAIL;
+
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < max_conns; i++) {
+        if (conns[i].handle == BLE_HS_CONN_HANDLE_NONE) {
+            continue;
+        }
+        int rc = ble_gap_terminate(conns[i].handle, BLE_ERR_REM_USER_CONN_TERM);
+        if (rc != 0) {
+            ESP_LOGE(TAG, "Failed to terminate connection %d: %d", conns[i].handle, rc);
+            ret = ESP_FAIL;
+        }
     }
     ESP_LOGI(TAG, "Disconnect requested");
-    return ESP_OK;
+    return ret;
 }
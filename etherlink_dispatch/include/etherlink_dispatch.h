@@ -0,0 +1,176 @@
+/**
+ * Etherlink RX Dispatcher
+ *
+ * Decouples protocol decode from the transport's receive context. Transports
+ * push received chunks into a preallocated pool-backed queue, and a dispatcher
+ * task of configurable priority runs the parser and on_message. Slow handlers
+ * then no longer stall the NimBLE host task or the UART RX task.
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#ifndef ETHERLINK_DISPATCH_H
+#define ETHERLINK_DISPATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "etherlink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Dispatcher instance (opaque)
+ */
+typedef struct el_dispatch el_dispatch_t;
+
+#define EL_DISPATCH_ITEM_SIZE   (sizeof(void *) + 8)    // One queued chunk descriptor
+#define EL_DISPATCH_MAX_CONTEXTS 8                      // Contexts one dispatcher serves
+
+/**
+ * Queue memory for a pool of the given size (free list + ready queue)
+ */
+#define EL_DISPATCH_QUEUE_BYTES(blocks) \
+    ((blocks) * sizeof(uint16_t) + ((blocks) + 1) * EL_DISPATCH_ITEM_SIZE)
+
+/**
+ * Caller-owned memory for EL_STATIC_ALLOC builds
+ *
+ * Reserve it with EL_DISPATCH_STORAGE_DEFINE. The sizes here replace
+ * pool_blocks, block_size and task_stack_size in el_dispatch_config_t.
+ */
+typedef struct {
+    uint8_t *pool;              // pool_blocks * block_size bytes
+    size_t pool_blocks;
+    size_t block_size;
+    uint8_t *queue_buf;         // EL_DISPATCH_QUEUE_BYTES(pool_blocks) bytes
+    StackType_t *task_stack;
+    uint32_t task_stack_size;   // Bytes
+} el_dispatch_storage_t;
+
+/**
+ * Reserve dispatcher storage at link time
+ *
+ *   EL_DISPATCH_STORAGE_DEFINE(rx_mem, 8, 256, 4096);
+ *   el_dispatch_config_t cfg = { ..., .storage = &rx_mem };
+ */
+#define EL_DISPATCH_STORAGE_DEFINE(name, blocks, block_bytes, stack)                 \
+    static uint8_t name##_pool[(blocks) * (block_bytes)];                           \
+    static uint8_t name##_queues[EL_DISPATCH_QUEUE_BYTES(blocks)]                   \
+        __attribute__((aligned(sizeof(void *))));                                   \
+    static StackType_t name##_stack[(stack) / sizeof(StackType_t)];                \
+    static const el_dispatch_storage_t name = {                                     \
+        .pool = name##_pool, .pool_blocks = (blocks), .block_size = (block_bytes),  \
+        .queue_buf = name##_queues,                                                 \
+        .task_stack = name##_stack, .task_stack_size = (stack),                     \
+    }
+
+/**
+ * Configuration for el_dispatch_create
+ */
+typedef struct {
+    el_ctx_t *protocol_ctx;     // Required: context whose on_message runs in the task
+    size_t pool_blocks;         // Chunk buffers in the pool (0 = default 8)
+    size_t block_size;          // Bytes per chunk buffer (0 = default 256)
+    uint32_t task_priority;     // Dispatcher task priority (0 = default 5)
+    uint32_t task_stack_size;   // Dispatcher task stack (0 = default 4096)
+    bool task_pinned;           // Pin the task to task_core (default: no affinity)
+    int task_core;              // Core for the task when task_pinned
+    const el_dispatch_storage_t *storage; // Required with EL_STATIC_ALLOC, ignored otherwise
+} el_dispatch_config_t;
+
+/**
+ * Dispatcher statistics
+ */
+typedef struct {
+    uint32_t chunks;            // Chunks delivered to the parser
+    uint32_t depth;             // Chunks currently queued
+    uint32_t high_water;        // Most chunks ever queued
+    uint32_t overflows;         // Chunks dropped because the pool was empty
+} el_dispatch_stats_t;
+
+/**
+ * Create a dispatcher and start its task
+ *
+ * All chunk buffers are allocated up front; pushing never allocates.
+ *
+ * @param config Configuration
+ * @param out Receives the dispatcher handle
+ * @return ESP_OK on success
+ */
+esp_err_t el_dispatch_create(const el_dispatch_config_t *config, el_dispatch_t **out);
+
+/**
+ * Queue received bytes for decoding in the dispatcher task
+ *
+ * Safe to call from any task (not from ISRs). Data larger than block_size is
+ * split across several buffers. If the pool runs dry the remainder is
+ * dropped and the parser is reset before the next chunk, so a partial frame
+ * is never glued to unrelated bytes.
+ *
+ * @param dispatch Dispatcher
+ * @param data Received data
+ * @param len Length of data
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if data was dropped
+ */
+esp_err_t el_dispatch_push(el_dispatch_t *dispatch, const uint8_t *data, size_t len);
+
+/**
+ * Queue received bytes for a specific context
+ *
+ * Like el_dispatch_push, but parses into ctx instead of the configured
+ * protocol_ctx. Lets one dispatcher serve several peers, each with its
+ * own parser state: up to EL_DISPATCH_MAX_CONTEXTS contexts, protocol_ctx
+ * included. Dropped data only resets the parser of the context it was
+ * meant for.
+ *
+ * @param dispatch Dispatcher
+ * @param ctx Context to parse into
+ * @param data Received data
+ * @param len Length of data
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if data was dropped (or ctx
+ *         would be one context too many)
+ */
+esp_err_t el_dispatch_push_ctx(el_dispatch_t *dispatch, el_ctx_t *ctx,
+                               const uint8_t *data, size_t len);
+
+/**
+ * Reset a specific context's parser from the dispatcher task
+ * @param dispatch Dispatcher
+ * @param ctx Context to reset
+ */
+void el_dispatch_reset_ctx(el_dispatch_t *dispatch, el_ctx_t *ctx);
+
+/**
+ * Reset the parser from the dispatcher task, in order with queued data
+ *
+ * Use instead of el_reset() while a dispatcher owns the context
+ * (e.g. on disconnect).
+ *
+ * @param dispatch Dispatcher
+ */
+void el_dispatch_reset(el_dispatch_t *dispatch);
+
+/**
+ * Get dispatcher statistics
+ * @param dispatch Dispatcher
+ * @param stats Filled with a snapshot of the counters
+ */
+void el_dispatch_get_stats(el_dispatch_t *dispatch, el_dispatch_stats_t *stats);
+
+/**
+ * Stop the dispatcher task and free the pool (queued chunks are discarded)
+ * @param dispatch Dispatcher
+ * @return ESP_OK on success
+ */
+esp_err_t el_dispatch_delete(el_dispatch_t *dispatch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERLINK_DISPATCH_H
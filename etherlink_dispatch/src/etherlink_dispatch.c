@@ -0,0 +1,329 @@
+/**
+ * Etherlink RX Dispatcher - Implementation
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink_dispatch.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "el_dispatch";
+
+#define DEFAULT_POOL_BLOCKS     8
+#define DEFAULT_BLOCK_SIZE      256
+#define DEFAULT_TASK_PRIORITY   5
+#define DEFAULT_TASK_STACK_SIZE 4096
+
+#if defined(CONFIG_ETHERLINK_DISPATCH_STATIC_INSTANCES)
+#define DISPATCH_STATIC_INSTANCES CONFIG_ETHERLINK_DISPATCH_STATIC_INSTANCES
+#else
+#define DISPATCH_STATIC_INSTANCES 2
+#endif
+
+#define BLOCK_NONE              0xFFFF  // Item carries no data (reset marker)
+
+// Queue item: which pool block holds the chunk
+typedef struct {
+    el_ctx_t *ctx;              // Context to parse into
+    uint16_t block;
+    uint16_t len;
+    bool reset;                 // Reset the parser before this chunk
+} dispatch_item_t;
+
+// A context served by the dispatcher, and whether its parser is owed a
+// reset before its next chunk (data was dropped, or a reset marker did not
+// fit in the ready queue)
+typedef struct {
+    el_ctx_t *ctx;
+    bool reset;
+} dispatch_peer_t;
+
+_Static_assert(sizeof(dispatch_item_t) == EL_DISPATCH_ITEM_SIZE, "update EL_DISPATCH_ITEM_SIZE");
+
+struct el_dispatch {
+    el_ctx_t *protocol_ctx;
+    uint8_t *pool;              // pool_blocks * block_size bytes
+    size_t pool_blocks;
+    size_t block_size;
+    QueueHandle_t free_q;       // Indices of free blocks
+    QueueHandle_t ready_q;      // Filled blocks, in arrival order
+    TaskHandle_t task;
+    dispatch_peer_t peers[EL_DISPATCH_MAX_CONTEXTS];
+    portMUX_TYPE peers_lock;    // Pushes and resets come from several tasks
+
+    // Statistics
+    uint32_t chunks;
+    uint32_t high_water;
+    uint32_t overflows;
+
+#if EL_STATIC_ALLOC
+    bool in_use;
+    StaticQueue_t free_q_buf;
+    StaticQueue_t ready_q_buf;
+    StaticTask_t task_buf;
+#endif
+};
+
+#if EL_STATIC_ALLOC
+static el_dispatch_t dispatch_pool[DISPATCH_STATIC_INSTANCES];
+#endif
+
+static el_dispatch_t *instance_alloc(void) {
+#if EL_STATIC_ALLOC
+    for (size_t i = 0; i < DISPATCH_STATIC_INSTANCES; i++) {
+        if (!dispatch_pool[i].in_use) {
+            memset(&dispatch_pool[i], 0, sizeof(el_dispatch_t));
+            dispatch_pool[i].in_use = true;
+            return &dispatch_pool[i];
+        }
+    }
+    return NULL;
+#else
+    return calloc(1, sizeof(el_dispatch_t));
+#endif
+}
+
+// Find ctx among the served contexts, adding it if there is room
+static dispatch_peer_t *peer_get(el_dispatch_t *d, el_ctx_t *ctx) {
+    dispatch_peer_t *free_slot = NULL;
+    for (size_t i = 0; i < EL_DISPATCH_MAX_CONTEXTS; i++) {
+        if (d->peers[i].ctx == ctx) {
+            return &d->peers[i];
+        }
+        if (!d->peers[i].ctx && !free_slot) {
+            free_slot = &d->peers[i];
+        }
+    }
+    if (free_slot) {
+        free_slot->ctx = ctx;
+        free_slot->reset = false;
+    }
+    return free_slot;
+}
+
+// Owe ctx a reset before its next chunk
+static void peer_set_reset(el_dispatch_t *d, el_ctx_t *ctx) {
+    portENTER_CRITICAL(&d->peers_lock);
+    dispatch_peer_t *peer = peer_get(d, ctx);
+    if (peer) {
+        peer->reset = true;
+    }
+    portEXIT_CRITICAL(&d->peers_lock);
+}
+
+// Take the reset owed to ctx. Returns false if ctx is one context too many.
+static bool peer_take_reset(el_dispatch_t *d, el_ctx_t *ctx, bool *reset) {
+    portENTER_CRITICAL(&d->peers_lock);
+    dispatch_peer_t *peer = peer_get(d, ctx);
+    if (peer) {
+        *reset = peer->reset;
+        peer->reset = false;
+    }
+    portEXIT_CRITICAL(&d->peers_lock);
+    return peer != NULL;
+}
+
+static void dispatch_task(void *arg) {
+    el_dispatch_t *d = arg;
+    dispatch_item_t item;
+
+    while (1) {
+        if (xQueueReceive(d->ready_q, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        if (item.reset) {
+            el_reset(item.ctx);
+        }
+
+        if (item.block != BLOCK_NONE) {
+            el_process_bytes(item.ctx, &d->pool[item.block * d->block_size], item.len);
+            d->chunks++;
+            xQueueSend(d->free_q, &item.block, 0);
+        }
+    }
+}
+
+esp_err_t el_dispatch_create(const el_dispatch_config_t *config, el_dispatch_t **out) {
+    if (!config || !config->protocol_ctx || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t pool_blocks = config->pool_blocks ? config->pool_blocks : DEFAULT_POOL_BLOCKS;
+    size_t block_size = config->block_size ? config->block_size : DEFAULT_BLOCK_SIZE;
+    uint32_t stack_size = config->task_stack_size ? config->task_stack_size
+                                                  : DEFAULT_TASK_STACK_SIZE;
+#if EL_STATIC_ALLOC
+    const el_dispatch_storage_t *mem = config->storage;
+    if (!mem || !mem->pool || !mem->queue_buf || !mem->task_stack) {
+        ESP_LOGE(TAG, "EL_STATIC_ALLOC: config->storage is required");
+        return ESP_ERR_INVALID_ARG;
+    }
+    pool_blocks = mem->pool_blocks;
+    block_size = mem->block_size;
+    stack_size = mem->task_stack_size;
+#endif
+    if (pool_blocks >= BLOCK_NONE || block_size > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    el_dispatch_t *d = instance_alloc();
+    if (!d) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    d->protocol_ctx = config->protocol_ctx;
+    d->peers[0].ctx = config->protocol_ctx;
+    portMUX_INITIALIZE(&d->peers_lock);
+    d->pool_blocks = pool_blocks;
+    d->block_size = block_size;
+    // One extra ready slot so a reset marker fits even with every block queued
+#if EL_STATIC_ALLOC
+    d->pool = mem->pool;
+    d->free_q = xQueueCreateStatic(pool_blocks, sizeof(uint16_t), mem->queue_buf, &d->free_q_buf);
+    d->ready_q = xQueueCreateStatic(pool_blocks + 1, sizeof(dispatch_item_t),
+                                    mem->queue_buf + pool_blocks * sizeof(uint16_t),
+                                    &d->ready_q_buf);
+#else
+    d->pool = malloc(pool_blocks * block_size);
+    d->free_q = xQueueCreate(pool_blocks, sizeof(uint16_t));
+    d->ready_q = xQueueCreate(pool_blocks + 1, sizeof(dispatch_item_t));
+#endif
+
+    if (!d->pool || !d->free_q || !d->ready_q) {
+        ESP_LOGE(TAG, "Failed to allocate dispatch pool");
+        el_dispatch_delete(d);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint16_t i = 0; i < pool_blocks; i++) {
+        xQueueSend(d->free_q, &i, 0);
+    }
+
+    UBaseType_t priority = config->task_priority ? config->task_priority : DEFAULT_TASK_PRIORITY;
+    BaseType_t core = config->task_pinned ? (BaseType_t)config->task_core : tskNO_AFFINITY;
+#if EL_STATIC_ALLOC
+    d->task = xTaskCreateStaticPinnedToCore(dispatch_task, "el_dispatch", stack_size, d, priority,
+                                            mem->task_stack, &d->task_buf, core);
+    BaseType_t task_ret = d->task ? pdPASS : pdFAIL;
+#else
+    BaseType_t task_ret = xTaskCreatePinnedToCore(dispatch_task, "el_dispatch", stack_size, d,
+                                                  priority, &d->task, core);
+#endif
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create dispatch task");
+        el_dispatch_delete(d);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Dispatcher started, %u x %u byte pool",
+             (unsigned)pool_blocks, (unsigned)block_size);
+
+    *out = d;
+    return ESP_OK;
+}
+
+esp_err_t el_dispatch_push(el_dispatch_t *d, const uint8_t *data, size_t len) {
+    return el_dispatch_push_ctx(d, d ? d->protocol_ctx : NULL, data, len);
+}
+
+esp_err_t el_dispatch_push_ctx(el_dispatch_t *d, el_ctx_t *ctx,
+                               const uint8_t *data, size_t len) {
+    if (!d || !ctx || (!data && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    while (len > 0) {
+        dispatch_item_t item = { .ctx = ctx };
+
+        if (xQueueReceive(d->free_q, &item.block, 0) != pdTRUE) {
+            // Pool exhausted: drop the rest, resync this context on its next chunk
+            d->overflows++;
+            peer_set_reset(d, ctx);
+            return ESP_ERR_NO_MEM;
+        }
+        if (!peer_take_reset(d, ctx, &item.reset)) {
+            ESP_LOGE(TAG, "More than %d contexts on one dispatcher", EL_DISPATCH_MAX_CONTEXTS);
+            xQueueSend(d->free_q, &item.block, 0);
+            return ESP_ERR_NO_MEM;
+        }
+
+        item.len = len < d->block_size ? (uint16_t)len : (uint16_t)d->block_size;
+        memcpy(&d->pool[item.block * d->block_size], data, item.len);
+
+        if (xQueueSend(d->ready_q, &item, 0) != pdTRUE) {
+            // Ready queue full of reset markers: give the block back and
+            // treat the rest as dropped
+            xQueueSend(d->free_q, &item.block, 0);
+            d->overflows++;
+            peer_set_reset(d, ctx);
+            return ESP_ERR_NO_MEM;
+        }
+
+        uint32_t depth = uxQueueMessagesWaiting(d->ready_q);
+        if (depth > d->high_water) {
+            d->high_water = depth;
+        }
+
+        data += item.len;
+        len -= item.len;
+    }
+
+    return ESP_OK;
+}
+
+void el_dispatch_reset(el_dispatch_t *d) {
+    el_dispatch_reset_ctx(d, d ? d->protocol_ctx : NULL);
+}
+
+void el_dispatch_reset_ctx(el_dispatch_t *d, el_ctx_t *ctx) {
+    if (!d || !ctx) {
+        return;
+    }
+
+    dispatch_item_t item = { .ctx = ctx, .block = BLOCK_NONE, .len = 0, .reset = true };
+    if (xQueueSend(d->ready_q, &item, 0) != pdTRUE) {
+        // Queue full: fold the reset into this context's next chunk instead
+        peer_set_reset(d, ctx);
+    }
+}
+
+void el_dispatch_get_stats(el_dispatch_t *d, el_dispatch_stats_t *stats) {
+    if (!d || !stats) {
+        return;
+    }
+
+    stats->chunks = d->chunks;
+    stats->depth = uxQueueMessagesWaiting(d->ready_q);
+    stats->high_water = d->high_water;
+    stats->overflows = d->overflows;
+}
+
+esp_err_t el_dispatch_delete(el_dispatch_t *d) {
+    if (!d) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (d->task) {
+        vTaskDelete(d->task);
+    }
+    if (d->ready_q) {
+        vQueueDelete(d->ready_q);
+    }
+    if (d->free_q) {
+        vQueueDelete(d->free_q);
+    }
+#if EL_STATIC_ALLOC
+    d->in_use = false;
+#else
+    free(d->pool);
+    free(d);
+#endif
+
+    return ESP_OK;
+}
@@ -0,0 +1,189 @@
+/**
+ * Etherlink OTA Sink
+ *
+ * Streams a firmware image received over the reliable channel
+ * (etherlink_reliable.h) into an OTA partition. The host sends, in order:
+ *
+ *   EL_MSG_OTA_BEGIN  [image size, uint32 LE]
+ *   EL_MSG_OTA_DATA   [image bytes...]        (repeated, up to 247 bytes each)
+ *   EL_MSG_OTA_END    []
+ *
+ * and the device answers EL_MSG_OTA_STATUS [el_ota_state_t] [bytes, uint32
+ * LE] [esp_err_t, int32 LE] on start, completion and failure.
+ *
+ * Chunks are copied once, from the parser's buffer into one of several
+ * flash-sector-sized buffers. A writer task programs full sectors and
+ * erases the next sector while the following buffer fills, so radio
+ * reception and flash work overlap. If the flash falls behind, the
+ * receiving task waits for a free buffer, which holds back ACKs and
+ * throttles the sender through its window. When the image is complete it
+ * is verified and selected with esp_ota_set_boot_partition.
+ *
+ * The channel is used from the receiving task and the writer task, so the
+ * el_rel_t needs its lock/unlock hooks set. Because the receiving task
+ * blocks while it waits for a buffer (up to buffer_timeout_ms), the
+ * protocol context must not be parsed in the NimBLE host task: with the
+ * BLE transport, attach an RX dispatcher (etherlink_dispatch.h).
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#ifndef ETHERLINK_OTA_H
+#define ETHERLINK_OTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "etherlink.h"
+#include "etherlink_reliable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EL_OTA_BUFFER_SIZE  4096    // One flash sector per buffer
+
+/**
+ * Queue memory for the given buffer count (free list + writer commands)
+ */
+#define EL_OTA_QUEUE_BYTES(buffers)     ((buffers) * 2 + ((buffers) + 2) * 6)
+
+/**
+ * Caller-owned memory for EL_STATIC_ALLOC builds
+ *
+ * Reserve it with EL_OTA_STORAGE_DEFINE. The sizes here replace
+ * buffer_count and task_stack_size in el_ota_config_t. One sink can exist
+ * at a time in this mode.
+ */
+typedef struct {
+    uint8_t *pool;                  // buffer_count * EL_OTA_BUFFER_SIZE bytes
+    size_t buffer_count;
+    uint8_t *queue_buf;             // EL_OTA_QUEUE_BYTES(buffer_count) bytes
+    StackType_t *task_stack;
+    uint32_t task_stack_size;       // Bytes
+} el_ota_storage_t;
+
+/**
+ * Reserve OTA sink storage at link time
+ *
+ *   EL_OTA_STORAGE_DEFINE(ota_mem, 2, 4096);
+ */
+#define EL_OTA_STORAGE_DEFINE(name, buffers, stack)                                  \
+    static uint8_t name##_pool[(buffers) * EL_OTA_BUFFER_SIZE]                      \
+        __attribute__((aligned(4)));                                                \
+    static uint8_t name##_queues[EL_OTA_QUEUE_BYTES(buffers)]                       \
+        __attribute__((aligned(4)));                                                \
+    static StackType_t name##_stack[(stack) / sizeof(StackType_t)];                \
+    static const el_ota_storage_t name = {                                          \
+        .pool = name##_pool, .buffer_count = (buffers),                             \
+        .queue_buf = name##_queues,                                                 \
+        .task_stack = name##_stack, .task_stack_size = (stack),                     \
+    }
+
+/**
+ * OTA sink instance (opaque)
+ */
+typedef struct el_ota el_ota_t;
+
+/**
+ * Transfer state, also sent in EL_MSG_OTA_STATUS
+ */
+typedef enum {
+    EL_OTA_IDLE = 0,
+    EL_OTA_RECEIVING,           // Between BEGIN and END
+    EL_OTA_FINISHING,           // END received, last writes and verification
+    EL_OTA_DONE,                // Image verified and set as boot partition
+    EL_OTA_FAILED,
+} el_ota_state_t;
+
+/**
+ * Transfer event callback
+ * @param user User pointer from the config
+ * @param state EL_OTA_RECEIVING (started), EL_OTA_DONE or EL_OTA_FAILED
+ * @param err Error code for EL_OTA_FAILED, ESP_OK otherwise
+ */
+typedef void (*el_ota_event_t)(void *user, el_ota_state_t state, esp_err_t err);
+
+/**
+ * Configuration for el_ota_create
+ */
+typedef struct {
+    el_rel_t *rel;                  // Required: channel for status replies
+    const esp_partition_t *partition; // Target app partition, not the running one
+                                    // (NULL = next update partition)
+    size_t buffer_count;            // Sector buffers (0 = default 2)
+    uint32_t buffer_timeout_ms;     // Max wait for a free buffer, blocking the
+                                    // receiving task (0 = default 5000)
+    uint32_t task_priority;         // Writer task priority (0 = default 5)
+    uint32_t task_stack_size;       // Writer task stack (0 = default 4096)
+    el_ota_event_t on_event;        // Optional: start/done/failed notification
+    void *user;                     // Passed to on_event
+    const el_ota_storage_t *storage; // Required with EL_STATIC_ALLOC, ignored otherwise
+} el_ota_config_t;
+
+/**
+ * Progress and throughput counters
+ */
+typedef struct {
+    el_ota_state_t state;
+    uint32_t image_size;            // From EL_MSG_OTA_BEGIN
+    uint32_t bytes_received;
+    uint32_t bytes_written;         // Programmed to flash
+    uint32_t buffer_waits;          // Times reception waited for the writer
+    uint32_t flash_us;              // Time spent erasing and writing
+    uint32_t elapsed_us;            // Since BEGIN (until done, while running)
+    uint32_t throughput_bps;        // Received bytes per second
+} el_ota_stats_t;
+
+/**
+ * Create an OTA sink and start its writer task
+ *
+ * All sector buffers are allocated up front.
+ *
+ * @param config Configuration
+ * @param out Receives the sink handle
+ * @return ESP_OK on success
+ */
+esp_err_t el_ota_create(const el_ota_config_t *config, el_ota_t **out);
+
+/**
+ * Feed a reliable-channel message to the sink
+ *
+ * Call from the channel's on_message for messages you do not handle
+ * yourself, or install el_ota_rel_handler as on_message directly.
+ *
+ * @param ota Sink
+ * @param msg_id Message type identifier
+ * @param payload Payload data
+ * @param len Payload length
+ * @return true if msg_id is an OTA message (consumed)
+ */
+bool el_ota_handle(el_ota_t *ota, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * el_handler_t adapter for el_rel_config_t.on_message (user = el_ota_t *)
+ */
+void el_ota_rel_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * Get progress and throughput counters
+ * @param ota Sink
+ * @param stats Output
+ */
+void el_ota_get_stats(el_ota_t *ota, el_ota_stats_t *stats);
+
+/**
+ * Stop the writer task and free the sink (abandons a running transfer)
+ * @param ota Sink
+ * @return ESP_OK on success
+ */
+esp_err_t el_ota_delete(el_ota_t *ota);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERLINK_OTA_H
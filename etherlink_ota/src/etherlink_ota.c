@@ -0,0 +1,497 @@
+/**
+ * Etherlink OTA Sink - Implementation
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink_ota.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "el_ota";
+
+#define DEFAULT_BUFFER_COUNT        2
+#define DEFAULT_BUFFER_TIMEOUT_MS   5000
+#define DEFAULT_TASK_PRIORITY       5
+#define DEFAULT_TASK_STACK_SIZE     4096
+
+#define WRITE_ALIGN                 16      // Flash encryption block
+#define STATUS_SIZE                 9       // state + bytes + err
+
+typedef enum {
+    OP_BEGIN,                   // Start a new image: erase its first sector
+    OP_WRITE,                   // Program one buffer
+    OP_FINISH,                  // Verify and select the image
+} writer_op_t;
+
+typedef struct {
+    uint8_t op;
+    uint16_t buf;
+    uint16_t len;
+} writer_cmd_t;
+
+_Static_assert(sizeof(writer_cmd_t) == 6, "update EL_OTA_QUEUE_BYTES");
+
+struct el_ota {
+    el_ota_config_t cfg;
+    uint8_t *pool;              // buffer_count * EL_OTA_BUFFER_SIZE bytes
+    QueueHandle_t free_q;       // Indices of free buffers
+    QueueHandle_t cmd_q;        // Work for the writer task, in order
+    TaskHandle_t task;
+
+    // Receive side (transport task)
+    const esp_partition_t *part;
+    int32_t cur;                // Buffer being filled (-1 = none)
+    size_t fill;
+
+    // Writer side
+    size_t write_off;
+    size_t erased_to;
+
+    // Shared
+    volatile el_ota_state_t state;
+    volatile esp_err_t err;
+    uint32_t image_size;
+    uint32_t bytes_received;
+    uint32_t bytes_written;
+    uint32_t buffer_waits;
+    uint32_t flash_us;
+    int64_t start_us;
+    int64_t end_us;
+
+#if EL_STATIC_ALLOC
+    bool in_use;
+    StaticQueue_t free_q_buf;
+    StaticQueue_t cmd_q_buf;
+    StaticTask_t task_buf;
+#endif
+};
+
+#if EL_STATIC_ALLOC
+static el_ota_t ota_instance;
+#endif
+
+/*******************************************************************************
+ * Status
+ ******************************************************************************/
+
+static void report(el_ota_t *ota, el_ota_state_t state, esp_err_t err) {
+    uint32_t bytes = ota->bytes_received;
+    uint8_t status[STATUS_SIZE] = {
+        (uint8_t)state,
+        (uint8_t)bytes, (uint8_t)(bytes >> 8), (uint8_t)(bytes >> 16), (uint8_t)(bytes >> 24),
+        (uint8_t)err, (uint8_t)((uint32_t)err >> 8),
+        (uint8_t)((uint32_t)err >> 16), (uint8_t)((uint32_t)err >> 24),
+    };
+
+    el_rel_send(ota->cfg.rel, EL_MSG_OTA_STATUS, status, sizeof(status));
+
+    if (ota->cfg.on_event) {
+        ota->cfg.on_event(ota->cfg.user, state, err);
+    }
+}
+
+static void fail(el_ota_t *ota, esp_err_t err) {
+    if (ota->state == EL_OTA_FAILED) {
+        return;
+    }
+
+    ota->err = err;
+    ota->state = EL_OTA_FAILED;
+    ota->end_us = esp_timer_get_time();
+    ESP_LOGE(TAG, "Update failed at %u bytes: %s",
+             (unsigned)ota->bytes_received, esp_err_to_name(err));
+    report(ota, EL_OTA_FAILED, err);
+}
+
+/*******************************************************************************
+ * Writer Task
+ ******************************************************************************/
+
+static esp_err_t erase_sector(el_ota_t *ota) {
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = esp_partition_erase_range(ota->part, ota->erased_to, EL_OTA_BUFFER_SIZE);
+    ota->flash_us += (uint32_t)(esp_timer_get_time() - t0);
+    ota->erased_to += EL_OTA_BUFFER_SIZE;
+    return err;
+}
+
+static esp_err_t write_buffer(el_ota_t *ota, uint8_t *buf, size_t len) {
+    esp_err_t err = ESP_OK;
+
+    // Normally erased ahead already; catch up if not
+    while (err == ESP_OK && ota->erased_to < ota->write_off + len) {
+        err = erase_sector(ota);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // Pad the final, partial buffer to the encryption block size
+    size_t padded = (len + WRITE_ALIGN - 1) & ~(size_t)(WRITE_ALIGN - 1);
+    memset(&buf[len], 0xFF, padded - len);
+
+    int64_t t0 = esp_timer_get_time();
+    err = esp_partition_write(ota->part, ota->write_off, buf, padded);
+    ota->flash_us += (uint32_t)(esp_timer_get_time() - t0);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ota->write_off += len;
+    ota->bytes_written += (uint32_t)len;
+
+    // Erase the next sector while the next buffer is being received
+    if (ota->erased_to < ota->image_size) {
+        err = erase_sector(ota);
+    }
+    return err;
+}
+
+static void writer_task(void *arg) {
+    el_ota_t *ota = arg;
+    writer_cmd_t cmd;
+
+    while (1) {
+        if (xQueueReceive(ota->cmd_q, &cmd, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        switch (cmd.op) {
+            case OP_BEGIN: {
+                ota->write_off = 0;
+                ota->erased_to = 0;
+                esp_err_t err = erase_sector(ota);
+                if (err != ESP_OK) {
+                    fail(ota, err);
+                }
+                break;
+            }
+
+            case OP_WRITE:
+                if (ota->state != EL_OTA_FAILED) {
+                    esp_err_t err = write_buffer(ota, &ota->pool[cmd.buf * EL_OTA_BUFFER_SIZE],
+                                                 cmd.len);
+                    if (err != ESP_OK) {
+                        fail(ota, err);
+                    }
+                }
+                xQueueSend(ota->free_q, &cmd.buf, 0);
+                break;
+
+            case OP_FINISH:
+                if (ota->state == EL_OTA_FINISHING) {
+                    // Verifies the image before selecting it
+                    esp_err_t err = esp_ota_set_boot_partition(ota->part);
+                    if (err != ESP_OK) {
+                        fail(ota, err);
+                        break;
+                    }
+                    ota->end_us = esp_timer_get_time();
+                    ota->state = EL_OTA_DONE;
+                    ESP_LOGI(TAG, "Update complete: %u bytes in %u ms",
+                             (unsigned)ota->bytes_written,
+                             (unsigned)((ota->end_us - ota->start_us) / 1000));
+                    report(ota, EL_OTA_DONE, ESP_OK);
+                }
+                break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Receive Side
+ ******************************************************************************/
+
+static void submit(el_ota_t *ota) {
+    writer_cmd_t cmd = { .op = OP_WRITE, .buf = (uint16_t)ota->cur, .len = (uint16_t)ota->fill };
+    xQueueSend(ota->cmd_q, &cmd, portMAX_DELAY);
+    ota->cur = -1;
+    ota->fill = 0;
+}
+
+static bool acquire(el_ota_t *ota) {
+    uint16_t idx;
+
+    if (xQueueReceive(ota->free_q, &idx, 0) != pdTRUE) {
+        // Flash is behind: wait, which also holds back our ACKs
+        ota->buffer_waits++;
+        if (xQueueReceive(ota->free_q, &idx, pdMS_TO_TICKS(ota->cfg.buffer_timeout_ms)) != pdTRUE) {
+            return false;
+        }
+    }
+
+    ota->cur = idx;
+    ota->fill = 0;
+    return true;
+}
+
+static void release_current(el_ota_t *ota) {
+    if (ota->cur >= 0) {
+        uint16_t idx = (uint16_t)ota->cur;
+        xQueueSend(ota->free_q, &idx, 0);
+        ota->cur = -1;
+        ota->fill = 0;
+    }
+}
+
+static void on_begin(el_ota_t *ota, const uint8_t *payload, uint8_t len) {
+    release_current(ota);
+
+    ota->image_size = 0;
+    ota->bytes_received = 0;
+    ota->bytes_written = 0;
+    ota->buffer_waits = 0;
+    ota->flash_us = 0;
+    ota->start_us = esp_timer_get_time();
+    ota->end_us = 0;
+    ota->err = ESP_OK;
+    ota->state = EL_OTA_RECEIVING;
+
+    if (len != 4) {
+        fail(ota, ESP_ERR_INVALID_ARG);
+        return;
+    }
+    ota->image_size = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) |
+                      ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+
+    ota->part = ota->cfg.partition ? ota->cfg.partition
+                                   : esp_ota_get_next_update_partition(NULL);
+    if (!ota->part) {
+        fail(ota, ESP_ERR_NOT_FOUND);
+        return;
+    }
+    // esp_ota_begin is bypassed, so make its checks here: never erase the
+    // image we are running from
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (ota->part->type != ESP_PARTITION_TYPE_APP) {
+        fail(ota, ESP_ERR_INVALID_ARG);
+        return;
+    }
+    if (running && running->address == ota->part->address) {
+        fail(ota, ESP_ERR_OTA_PARTITION_CONFLICT);
+        return;
+    }
+    if (ota->image_size == 0 || ota->image_size > ota->part->size) {
+        fail(ota, ESP_ERR_INVALID_SIZE);
+        return;
+    }
+
+    writer_cmd_t cmd = { .op = OP_BEGIN };
+    xQueueSend(ota->cmd_q, &cmd, portMAX_DELAY);
+
+    ESP_LOGI(TAG, "Receiving %u byte image into %s",
+             (unsigned)ota->image_size, ota->part->label);
+    report(ota, EL_OTA_RECEIVING, ESP_OK);
+}
+
+static void on_data(el_ota_t *ota, const uint8_t *payload, uint8_t len) {
+    if (ota->state != EL_OTA_RECEIVING) {
+        return;
+    }
+    if (ota->bytes_received + len > ota->image_size) {
+        release_current(ota);
+        fail(ota, ESP_ERR_INVALID_SIZE);
+        return;
+    }
+
+    ota->bytes_received += len;
+
+    while (len > 0) {
+        if (ota->cur < 0 && !acquire(ota)) {
+            fail(ota, ESP_ERR_TIMEOUT);
+            return;
+        }
+
+        size_t n = EL_OTA_BUFFER_SIZE - ota->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&ota->pool[ota->cur * EL_OTA_BUFFER_SIZE + ota->fill], payload, n);
+        ota->fill += n;
+        payload += n;
+        len -= (uint8_t)n;
+
+        if (ota->fill == EL_OTA_BUFFER_SIZE) {
+            submit(ota);
+        }
+    }
+}
+
+static void on_end(el_ota_t *ota) {
+    if (ota->state != EL_OTA_RECEIVING) {
+        return;
+    }
+    if (ota->bytes_received != ota->image_size) {
+        release_current(ota);
+        fail(ota, ESP_ERR_INVALID_SIZE);
+        return;
+    }
+
+    ota->state = EL_OTA_FINISHING;
+    if (ota->cur >= 0) {
+        submit(ota);
+    }
+
+    writer_cmd_t cmd = { .op = OP_FINISH };
+    xQueueSend(ota->cmd_q, &cmd, portMAX_DELAY);
+}
+
+bool el_ota_handle(el_ota_t *ota, uint8_t msg_id, const void *payload, uint8_t len) {
+    if (!ota) {
+        return false;
+    }
+
+    switch (msg_id) {
+        case EL_MSG_OTA_BEGIN:
+            on_begin(ota, payload, len);
+            return true;
+        case EL_MSG_OTA_DATA:
+            on_data(ota, payload, len);
+            return true;
+        case EL_MSG_OTA_END:
+            on_end(ota);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void el_ota_rel_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len) {
+    el_ota_handle((el_ota_t *)user, msg_id, payload, len);
+}
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+esp_err_t el_ota_create(const el_ota_config_t *config, el_ota_t **out) {
+    if (!config || !config->rel || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if EL_STATIC_ALLOC
+    const el_ota_storage_t *mem = config->storage;
+    if (!mem || !mem->pool || !mem->queue_buf || !mem->task_stack || !mem->buffer_count) {
+        ESP_LOGE(TAG, "EL_STATIC_ALLOC: config->storage is required");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ota_instance.in_use) {
+        return ESP_ERR_NO_MEM;
+    }
+    el_ota_t *ota = &ota_instance;
+    memset(ota, 0, sizeof(*ota));
+    ota->in_use = true;
+#else
+    el_ota_t *ota = calloc(1, sizeof(el_ota_t));
+    if (!ota) {
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+
+    ota->cfg = *config;
+#if EL_STATIC_ALLOC
+    ota->cfg.buffer_count = mem->buffer_count;
+    ota->cfg.task_stack_size = mem->task_stack_size;
+#endif
+    if (ota->cfg.buffer_count == 0) {
+        ota->cfg.buffer_count = DEFAULT_BUFFER_COUNT;
+    }
+    if (ota->cfg.buffer_timeout_ms == 0) {
+        ota->cfg.buffer_timeout_ms = DEFAULT_BUFFER_TIMEOUT_MS;
+    }
+    ota->cur = -1;
+    ota->state = EL_OTA_IDLE;
+
+    size_t count = ota->cfg.buffer_count;
+    // Every buffer plus BEGIN and FINISH can be queued at once
+#if EL_STATIC_ALLOC
+    ota->pool = mem->pool;
+    ota->free_q = xQueueCreateStatic(count, sizeof(uint16_t), mem->queue_buf, &ota->free_q_buf);
+    ota->cmd_q = xQueueCreateStatic(count + 2, sizeof(writer_cmd_t),
+                                    mem->queue_buf + count * sizeof(uint16_t), &ota->cmd_q_buf);
+#else
+    ota->pool = malloc(count * EL_OTA_BUFFER_SIZE);
+    ota->free_q = xQueueCreate(count, sizeof(uint16_t));
+    ota->cmd_q = xQueueCreate(count + 2, sizeof(writer_cmd_t));
+#endif
+
+    if (!ota->pool || !ota->free_q || !ota->cmd_q) {
+        ESP_LOGE(TAG, "Failed to allocate OTA buffers");
+        el_ota_delete(ota);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        xQueueSend(ota->free_q, &i, 0);
+    }
+
+    uint32_t stack_size = ota->cfg.task_stack_size ? ota->cfg.task_stack_size
+                                                   : DEFAULT_TASK_STACK_SIZE;
+    UBaseType_t priority = config->task_priority ? config->task_priority : DEFAULT_TASK_PRIORITY;
+#if EL_STATIC_ALLOC
+    ota->task = xTaskCreateStatic(writer_task, "el_ota", stack_size, ota, priority,
+                                  mem->task_stack, &ota->task_buf);
+    BaseType_t task_ret = ota->task ? pdPASS : pdFAIL;
+#else
+    BaseType_t task_ret = xTaskCreate(writer_task, "el_ota", stack_size, ota, priority,
+                                      &ota->task);
+#endif
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create OTA writer task");
+        el_ota_delete(ota);
+        return ESP_FAIL;
+    }
+
+    *out = ota;
+    return ESP_OK;
+}
+
+void el_ota_get_stats(el_ota_t *ota, el_ota_stats_t *stats) {
+    if (!ota || !stats) {
+        return;
+    }
+
+    int64_t end = ota->end_us ? ota->end_us : esp_timer_get_time();
+    int64_t elapsed = ota->state == EL_OTA_IDLE ? 0 : end - ota->start_us;
+
+    stats->state = ota->state;
+    stats->image_size = ota->image_size;
+    stats->bytes_received = ota->bytes_received;
+    stats->bytes_written = ota->bytes_written;
+    stats->buffer_waits = ota->buffer_waits;
+    stats->flash_us = ota->flash_us;
+    stats->elapsed_us = (uint32_t)elapsed;
+    stats->throughput_bps = elapsed > 0
+        ? (uint32_t)((int64_t)ota->bytes_received * 1000000 / elapsed) : 0;
+}
+
+esp_err_t el_ota_delete(el_ota_t *ota) {
+    if (!ota) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (ota->task) {
+        vTaskDelete(ota->task);
+    }
+    if (ota->cmd_q) {
+        vQueueDelete(ota->cmd_q);
+    }
+    if (ota->free_q) {
+        vQueueDelete(ota->free_q);
+    }
+#if EL_STATIC_ALLOC
+    ota->in_use = false;
+#else
+    free(ota->pool);
+    free(ota);
+#endif
+
+    return ESP_OK;
+}
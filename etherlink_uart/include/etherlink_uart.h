@@ -14,12 +14,86 @@
 #include <stdbool.h>
 #include "esp_err.h"
 #include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
 #include "etherlink.h"
+#include "etherlink_dispatch.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * UART transport instance (one per port)
+ */
+typedef struct el_uart_s el_uart_t;
+
+/**
+ * UART backend
+ */
+typedef enum {
+    EL_UART_BACKEND_DRIVER,     // Interrupt-driven ESP-IDF UART driver (default)
+    EL_UART_BACKEND_DMA,        // UHCI/GDMA, for multi-megabaud links (ESP-IDF >= 5.5,
+                                // chips with UHCI)
+} el_uart_backend_t;
+
+/**
+ * Hardware flow control
+ */
+typedef enum {
+    EL_UART_FLOW_NONE,          // No flow control (default)
+    EL_UART_FLOW_RTS,           // Raise RTS when our RX FIFO fills
+    EL_UART_FLOW_CTS,           // Pause TX while the peer deasserts CTS
+    EL_UART_FLOW_RTS_CTS,       // Both directions
+} el_uart_flow_t;
+
+/**
+ * Memory for the RX read buffer
+ */
+typedef enum {
+    EL_UART_MEM_DEFAULT,        // malloc() heap (default)
+    EL_UART_MEM_INTERNAL,       // Internal RAM, fastest to parse from
+    EL_UART_MEM_SPIRAM,         // PSRAM, to keep large buffers out of internal RAM
+} el_uart_mem_t;
+
+#define EL_UART_DMA_TX_BUF_SIZE 1024   // DMA backend TX staging buffer
+
+/**
+ * Caller-owned memory for EL_STATIC_ALLOC builds
+ *
+ * Reserve it with EL_UART_STORAGE_DEFINE. The sizes here replace
+ * rx_buf_size and the task stack sizes in el_uart_config_t.
+ */
+typedef struct {
+    uint8_t *rx_buf;                // Driver backend: read buffer
+    size_t rx_buf_size;             // Also the driver RX ring size
+    StackType_t *rx_task_stack;
+    uint32_t rx_task_stack_size;    // Bytes
+    StackType_t *tx_task_stack;     // Contexts with a TX ring only
+    uint32_t tx_task_stack_size;    // Bytes
+    uint8_t *dma_rx_buf[2];         // DMA backend: dma_rx_buf_size bytes each,
+                                    // DMA-capable internal RAM
+    uint8_t *dma_tx_buf;            // DMA backend: EL_UART_DMA_TX_BUF_SIZE bytes
+} el_uart_storage_t;
+
+/**
+ * Reserve UART storage at link time (driver backend)
+ *
+ * Pass tx_stack = 0 when the context has no TX ring.
+ *
+ *   EL_UART_STORAGE_DEFINE(uart1_mem, 2048, 4096, 2048);
+ *   el_uart_config_t cfg = { ..., .storage = &uart1_mem };
+ */
+#define EL_UART_STORAGE_DEFINE(name, rx_size, rx_stack, tx_stack)                    \
+    static uint8_t name##_rx_buf[rx_size];                                          \
+    static StackType_t name##_rx_stack[(rx_stack) / sizeof(StackType_t)];          \
+    static StackType_t name##_tx_stack[(tx_stack) / sizeof(StackType_t)];          \
+    static const el_uart_storage_t name = {                                         \
+        .rx_buf = name##_rx_buf, .rx_buf_size = (rx_size),                          \
+        .rx_task_stack = name##_rx_stack, .rx_task_stack_size = (rx_stack),         \
+        .tx_task_stack = (tx_stack) ? name##_tx_stack : NULL,                       \
+        .tx_task_stack_size = (tx_stack),                                           \
+    }
+
 /**
  * Configuration for Etherlink UART transport
  */
@@ -29,22 +103,176 @@ typedef struct {
     int tx_pin;                 // TX GPIO pin (-1 for default)
     int rx_pin;                 // RX GPIO pin (-1 for default)
     el_ctx_t *protocol_ctx;     // Etherlink protocol context (auto-wires RX)
+    el_dispatch_t *dispatch;    // Optional: decode in this dispatcher's task
+                                // instead of the UART RX task
+
+    // Event-driven RX: wake on driver events (FIFO threshold or RX timeout)
+    // and hand over whatever is buffered, instead of polling every 100 ms
+    bool rx_event_driven;       // Use the UART event queue
+    uint8_t rx_full_thresh;     // RX FIFO full threshold in bytes (0 = driver default)
+    uint8_t rx_timeout;         // RX idle timeout in symbols (0 = driver default)
+
+    // Backend selection. The DMA backend receives into two alternating DMA
+    // buffers and parses straight out of them; the next one is armed as
+    // soon as the current one completes, unless parsing is a whole buffer
+    // behind. The event-driven options above apply to the driver backend only.
+    el_uart_backend_t backend;  // Backend (default: EL_UART_BACKEND_DRIVER)
+    size_t dma_rx_buf_size;     // DMA: bytes per RX buffer half (0 = 4096)
+
+    // Hardware flow control. With RTS enabled the UART deasserts RTS once
+    // rx_flow_thresh bytes sit in the RX FIFO, so a fast host pauses
+    // instead of overrunning the driver buffer.
+    el_uart_flow_t flow_ctrl;   // Flow control mode (default: none)
+    int rts_pin;                // RTS GPIO pin, used with RTS modes (-1 for default)
+    int cts_pin;                // CTS GPIO pin, used with CTS modes (-1 for default)
+    uint8_t rx_flow_thresh;     // RTS threshold in FIFO bytes (0 = 100)
+
+    // Baud negotiation, responder side (see el_uart_negotiate_baud)
+    int max_baud;               // Highest rate a peer may switch us to (0 = no limit)
+    uint16_t baud_revert_ms;    // Revert unless confirmed within this time,
+                                // plus the probe time (0 = 1000)
+
+    // Buffers and tasks. Zero fields take the menuconfig defaults
+    // (Component config -> Etherlink UART). The driver backend sizes both
+    // its RX ring and the read buffer from rx_buf_size, which must exceed
+    // the hardware FIFO (128 bytes).
+    size_t rx_buf_size;         // Driver RX ring and read chunk (0 = 1024)
+    size_t tx_buf_size;         // Driver TX ring (0 = 512)
+    el_uart_mem_t buffer_mem;   // Where the read buffer is allocated
+    uint32_t rx_task_stack_size; // RX task stack in bytes (0 = 4096)
+    uint8_t rx_task_priority;   // RX task priority (0 = 10)
+    uint32_t tx_task_stack_size; // TX task stack in bytes (0 = 2048)
+    uint8_t tx_task_priority;   // TX task priority (0 = 10)
+    bool task_pinned;           // Pin the RX/TX tasks to task_core (otherwise
+                                // the menuconfig core, default: no affinity)
+    int task_core;              // Core for the RX/TX tasks when task_pinned
+
+    const el_uart_storage_t *storage; // Required with EL_STATIC_ALLOC, ignored otherwise
 } el_uart_config_t;
 
+/*******************************************************************************
+ * Baud Negotiation
+ *
+ * Both ends start at a rate that always works. The initiator then walks a
+ * list of faster rates; for each one it carries an EL_MSG_VERSION frame
+ * whose payload starts with EL_UART_BAUD_TAG:
+ *
+ *   PROPOSE rate   ->  ACCEPT        (both switch to the new rate)
+ *   probes, END    ->  probes, REPORT (probes: patterned frames both ways)
+ *   CONFIRM        ->                 (both counted all probes, no errors)
+ *
+ * The first rate that does not run clean ends the walk: the initiator goes
+ * back to the last good rate, and the responder, never having seen
+ * CONFIRM, does the same when its revert timer expires. Run it while the
+ * link is otherwise idle.
+ ******************************************************************************/
+
+#define EL_UART_BAUD_TAG        0xBA    // EL_MSG_VERSION payload[0] for baud negotiation
+
 /**
- * Initialize UART transport with Etherlink integration
+ * Create a UART transport instance
  *
  * This initializes:
- * - ESP-IDF UART driver
+ * - ESP-IDF UART driver (or the UHCI DMA controller)
  * - RX event task that feeds data to Etherlink parser
  *
  * If protocol_ctx is provided, received data will be automatically
- * passed to el_process_bytes(). You still need to set send_bytes
- * callback in the protocol config to el_uart_send_raw().
+ * passed to el_process_bytes(). Bind the context's TX side to this
+ * instance with el_bind_transport(ctx, el_uart_send_rawv, NULL, uart).
+ *
+ * If protocol_ctx was initialized with a TX ring, a sender task is also
+ * started: el_send only queues frames, and the task writes them to the
+ * driver in large chunks.
+ *
+ * Any number of instances can run side by side, one per UART port, each
+ * with its own protocol context.
  *
  * @param config Configuration
+ * @param[out] out Created instance
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the DMA backend is
+ *         not available on this chip/IDF version
+ */
+esp_err_t el_uart_create(const el_uart_config_t *config, el_uart_t **out);
+
+/**
+ * Write data to a UART instance
+ * @param uart Instance
+ * @param data Data to send
+ * @param len Length of data
+ * @return ESP_OK on success
+ */
+esp_err_t el_uart_write(el_uart_t *uart, const uint8_t *data, size_t len);
+
+/**
+ * Delete a UART instance, stopping its tasks and releasing the port
+ * @param uart Instance
  * @return ESP_OK on success
  */
+esp_err_t el_uart_delete(el_uart_t *uart);
+
+/**
+ * Send a frame from segments over UART (use as send_bytesv callback)
+ * @param user UART instance, or NULL for the el_uart_init() instance
+ * @param iov Segments to send
+ * @param iovcnt Number of segments
+ */
+void el_uart_send_rawv(void *user, const el_iovec_t *iov, size_t iovcnt);
+
+/**
+ * Change the baud rate of an instance (e.g. back to the safe rate after
+ * a reconnect)
+ * @param uart Instance
+ * @param baud New baud rate
+ * @return ESP_OK on success
+ */
+esp_err_t el_uart_set_baud(el_uart_t *uart, int baud);
+
+/**
+ * Step the link up to the fastest rate both ends run without errors
+ *
+ * Blocks until done. The peer must pass its EL_MSG_VERSION frames to
+ * el_uart_handle_message, and so must this side (for the replies).
+ *
+ * @param uart Instance (needs a protocol_ctx)
+ * @param rates Candidate rates, ascending, all above the current one
+ * @param count Number of rates
+ * @param[out] out_baud Rate in use afterwards (the current one if none worked)
+ * @return ESP_OK when done, ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE on
+ *         bad arguments or an instance without protocol context
+ */
+esp_err_t el_uart_negotiate_baud(el_uart_t *uart, const int *rates, size_t count, int *out_baud);
+
+/**
+ * Handle baud negotiation frames
+ *
+ * Call from on_message (or a handler) with every received frame; frames
+ * that are not EL_MSG_VERSION with EL_UART_BAUD_TAG are left to you.
+ * It does not block: the responder steps (ACCEPT and the switch, probes,
+ * timer reverts) run in the instance's RX task between reads.
+ *
+ * @param uart Instance the frame arrived on
+ * @param msg_id Message type identifier
+ * @param payload Payload data
+ * @param len Payload length
+ * @return true if the frame was consumed
+ */
+bool el_uart_handle_message(el_uart_t *uart, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * el_handler_t adapter for el_register_handler(ctx, EL_MSG_VERSION, ...)
+ * (user = el_uart_t *)
+ */
+void el_uart_baud_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len);
+
+/**
+ * Initialize the default UART instance
+ *
+ * Single-port shorthand for el_uart_create(). el_uart_send_raw(),
+ * el_uart_send() and el_uart_deinit() operate on this instance.
+ *
+ * @param config Configuration
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already initialized
+ */
 esp_err_t el_uart_init(const el_uart_config_t *config);
 
 /**
@@ -55,7 +283,7 @@ esp_err_t el_uart_init(const el_uart_config_t *config);
 void el_uart_send_raw(const uint8_t *data, size_t len);
 
 /**
- * Send data over UART
+ * Send data over the default UART instance
  * @param data Data to send
  * @param len Length of data
  * @return ESP_OK on success
@@ -63,7 +291,7 @@ void el_uart_send_raw(const uint8_t *data, size_t len);
 esp_err_t el_uart_send(const uint8_t *data, size_t len);
 
 /**
- * Deinitialize UART transport
+ * Deinitialize the default UART instance
  * @return ESP_OK on success
  */
 esp_err_t el_uart_deinit(void);
@@ -8,54 +8,1012 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/timers.h"
+#include "esp_idf_version.h"
+#include "soc/soc_caps.h"
+#include "esp_heap_caps.h"
+#include <stdlib.h>
 #include <string.h>
 
+#if SOC_UHCI_SUPPORTED && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 5, 0)
+#define EL_UART_HAVE_DMA    1
+#include "driver/uhci.h"
+#include "esp_attr.h"
+#include "freertos/semphr.h"
+#endif
+
 static const char *TAG = "el_uart";
 
+// Defaults for zero config fields (menuconfig: Etherlink UART)
+#if defined(CONFIG_ETHERLINK_UART_RX_BUF_SIZE)
+#define UART_RX_BUF_SIZE    CONFIG_ETHERLINK_UART_RX_BUF_SIZE
+#define UART_TX_BUF_SIZE    CONFIG_ETHERLINK_UART_TX_BUF_SIZE
+#define RX_TASK_STACK_SIZE  CONFIG_ETHERLINK_UART_RX_TASK_STACK_SIZE
+#define RX_TASK_PRIORITY    CONFIG_ETHERLINK_UART_RX_TASK_PRIORITY
+#define TX_TASK_STACK_SIZE  CONFIG_ETHERLINK_UART_TX_TASK_STACK_SIZE
+#define TX_TASK_PRIORITY    CONFIG_ETHERLINK_UART_TX_TASK_PRIORITY
+#else
 #define UART_RX_BUF_SIZE    1024
 #define UART_TX_BUF_SIZE    512
 #define RX_TASK_STACK_SIZE  4096
 #define RX_TASK_PRIORITY    10
+#define TX_TASK_STACK_SIZE  2048
+#define TX_TASK_PRIORITY    10
+#endif
+
+#if defined(CONFIG_ETHERLINK_UART_TASK_CORE) && CONFIG_ETHERLINK_UART_TASK_CORE >= 0
+#define UART_TASK_CORE      CONFIG_ETHERLINK_UART_TASK_CORE
+#else
+#define UART_TASK_CORE      tskNO_AFFINITY
+#endif
+
+#define UART_EVENT_QUEUE_LEN 20
+#define RX_FLOW_THRESH      100     // Default RTS threshold (FIFO bytes)
+
+#define BAUD_REVERT_MS      1000    // Default responder revert timeout
+#define BAUD_ACCEPT_MS      200     // Initiator wait for ACCEPT / REJECT
+#define BAUD_SETTLE_MS      10      // Initiator pause after switching
+#define BAUD_PROBE_COUNT    8       // Probe frames per direction
+#define BAUD_PROBE_LEN      128     // Probe payload bytes
+#define BAUD_QUEUE_LEN      4
+
+// Baud negotiation ops (payload[1], after EL_UART_BAUD_TAG)
+typedef enum {
+    BAUD_PROPOSE = 1,           // [rate u32]
+    BAUD_ACCEPT,                // [rate u32]
+    BAUD_REJECT,
+    BAUD_PROBE,                 // [seq] [pattern...]
+    BAUD_PROBE_END,             // Initiator's probes done, send yours
+    BAUD_REPORT,                // [probes ok u16] [rx errors u16]
+    BAUD_CONFIRM,               // Keep the new rate
+} baud_op_t;
+
+// Responder work, flagged by the handler or the revert timer and run by the
+// RX task between reads (never inside the parser, never in the timer task)
+#define BAUD_WORK_REVERT    0x01    // Revert timer fired
+#define BAUD_WORK_CONFIRM   0x02    // CONFIRM received, keep the new rate
+#define BAUD_WORK_SWITCH    0x04    // PROPOSE accepted: ACCEPT, drain, switch
+#define BAUD_WORK_PROBES    0x08    // END received: send probes, then REPORT
+
+// Reply for the negotiating task
+typedef struct {
+    uint8_t op;
+    uint32_t a;
+    uint32_t b;
+} baud_event_t;
+
+#if EL_UART_HAVE_DMA
+#define DMA_RX_BUF_SIZE     4096    // Default bytes per RX half
+#define DMA_TX_BUF_SIZE     EL_UART_DMA_TX_BUF_SIZE
+#define DMA_RX_QUEUE_LEN    16
+#define DMA_RX_RETRY_MS     10      // Re-arm retry while no half is armed
+
+// RX chunk reported by the UHCI ISR
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    bool done;                      // Buffer half complete, DMA needs a new one
+    uint8_t half;                   // dma_rx_buf index the chunk is in
+} dma_rx_event_t;
+
+// RX buffer half, as seen by the RX task and the ISR
+typedef enum {
+    DMA_HALF_FREE,                  // Parsed, may be armed
+    DMA_HALF_ARMED,                 // uhci_receive in progress
+    DMA_HALF_FILLED,                // Complete, chunks not all parsed yet
+} dma_half_t;
+
+#endif
+
+struct el_uart_s {
+    uart_port_t port;
+    el_ctx_t *protocol_ctx;
+    el_dispatch_t *dispatch;
+    TaskHandle_t rx_task_handle;
+    TaskHandle_t tx_task_handle;
+    QueueHandle_t event_queue;
+    el_uart_backend_t backend;
+    int baud;
+    uint8_t *rx_buf;                // Driver backend: uart_read_bytes target
+    size_t rx_buf_size;
+
+    // Baud negotiation
+    int max_baud;
+    uint32_t baud_revert_ms;
+    volatile int baud_fallback;     // Rate to revert to (0 = none pending)
+    TimerHandle_t baud_timer;       // Responder revert timer
+    QueueHandle_t baud_q;           // Replies for el_uart_negotiate_baud
+    uint16_t probes_ok;             // Valid probes since the last switch
+    uint32_t errors_base;           // protocol_ctx->rx_errors at the last switch
+    uint8_t baud_work;              // BAUD_WORK_* pending for the RX task
+    int baud_next;                  // Rate for BAUD_WORK_SWITCH
+    uint8_t baud_report[4];         // REPORT for BAUD_WORK_PROBES
+
+    // Link statistics (el_get_stats)
+    volatile uint32_t rx_overflows; // RX overflow events / DMA chunks lost
+    uint32_t tx_failures;           // Frames the driver refused
+
+#if EL_UART_HAVE_DMA
+    uhci_controller_handle_t uhci;
+    uint8_t *dma_rx_buf[2];
+    size_t dma_rx_buf_size;
+    int dma_rx_active;              // Half armed last
+    volatile dma_half_t dma_rx_state[2];
+    QueueHandle_t dma_rx_queue;
+    uint8_t *dma_tx_buf;
+    SemaphoreHandle_t dma_tx_done;
+    SemaphoreHandle_t dma_tx_lock;
+#endif
+
+#if EL_STATIC_ALLOC
+    // Control blocks for the FreeRTOS static APIs
+    bool in_use;
+    StaticTask_t rx_task_buf;
+    StaticTask_t tx_task_buf;
+    StaticTimer_t baud_timer_buf;
+    StaticQueue_t baud_q_buf;
+    uint8_t baud_q_storage[BAUD_QUEUE_LEN * sizeof(baud_event_t)];
+#if EL_UART_HAVE_DMA
+    StaticQueue_t dma_rx_queue_buf;
+    uint8_t dma_rx_queue_storage[DMA_RX_QUEUE_LEN * sizeof(dma_rx_event_t)];
+    StaticSemaphore_t dma_tx_done_buf;
+    StaticSemaphore_t dma_tx_lock_buf;
+#endif
+#endif
+};
+
+#if EL_STATIC_ALLOC
+static el_uart_t uart_pool[UART_NUM_MAX];   // One instance per port
+#endif
+
+// Instance behind the el_uart_init() / el_uart_send() convenience API
+static el_uart_t *default_uart = NULL;
+
+static void baud_run(el_uart_t *u);
+
+static void uart_deliver(el_uart_t *u, const uint8_t *data, size_t len) {
+    if (len > 0 && u->dispatch && u->protocol_ctx) {
+        el_dispatch_push_ctx(u->dispatch, u->protocol_ctx, data, len);
+    } else if (len > 0 && u->protocol_ctx) {
+        el_process_bytes(u->protocol_ctx, data, len);
+    }
+}
+
+static void uart_resync(el_uart_t *u) {
+    if (u->dispatch && u->protocol_ctx) {
+        el_dispatch_reset_ctx(u->dispatch, u->protocol_ctx);
+    } else if (u->protocol_ctx) {
+        el_reset(u->protocol_ctx);
+    }
+}
+
+// Event-driven RX: the driver posts UART_DATA on FIFO threshold or RX
+// timeout, so only the bytes already buffered are read and nothing waits.
+// Does not return.
+static void uart_rx_event_loop(el_uart_t *u) {
+    uint8_t *data = u->rx_buf;
+    uart_event_t event;
+
+    while (1) {
+        if (xQueueReceive(u->event_queue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        switch (event.type) {
+            case UART_DATA: {
+                size_t buffered = 0;
+                uart_get_buffered_data_len(u->port, &buffered);
+                while (buffered > 0) {
+                    size_t want = buffered < u->rx_buf_size ? buffered : u->rx_buf_size;
+                    int len = uart_read_bytes(u->port, data, want, 0);
+                    if (len <= 0) {
+                        break;
+                    }
+                    uart_deliver(u, data, len);
+                    buffered -= len;
+                }
+                break;
+            }
+
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                // Bytes were lost; drop the backlog and resync the parser
+                ESP_LOGW(TAG, "RX overflow, flushing");
+                u->rx_overflows++;
+                uart_flush_input(u->port);
+                xQueueReset(u->event_queue);
+                uart_resync(u);
+                break;
+
+            default:
+                // UART_EVENT_MAX: baud_kick
+                break;
+        }
+
+        baud_run(u);
+    }
+}
+
+#if EL_UART_HAVE_DMA
+/*******************************************************************************
+ * UHCI DMA Backend
+ ******************************************************************************/
+
+static bool IRAM_ATTR dma_on_rx(uhci_controller_handle_t ctrl,
+                                const uhci_rx_event_data_t *edata, void *user) {
+    el_uart_t *u = user;
+    dma_rx_event_t ev = {
+        .data = edata->data,
+        .len = edata->recv_size,
+        .done = edata->flags.totally_received,
+        .half = (uint8_t)u->dma_rx_active,
+    };
+    if (ev.done) {
+        // Lets the RX task arm the other half before it reaches this event
+        u->dma_rx_state[u->dma_rx_active] = DMA_HALF_FILLED;
+    }
+    BaseType_t woken = pdFALSE;
+    if (xQueueSendFromISR(u->dma_rx_queue, &ev, &woken) != pdTRUE) {
+        u->rx_overflows++;
+        if (ev.done) {
+            // Nothing will report this half parsed; its bytes are lost anyway
+            u->dma_rx_state[ev.half] = DMA_HALF_FREE;
+        }
+    }
+    return woken == pdTRUE;
+}
+
+static bool IRAM_ATTR dma_on_tx_done(uhci_controller_handle_t ctrl,
+                                     const uhci_tx_done_event_data_t *edata, void *user) {
+    el_uart_t *u = user;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(u->dma_tx_done, &woken);
+    return woken == pdTRUE;
+}
+
+// UHCI takes one receive at a time, so the next half is armed as soon as
+// the active one completes and the next one has been parsed, checked before
+// every chunk rather than when the task gets to the completion event. The
+// UART FIFO carries the line across the re-arm. False while nothing is armed.
+static bool dma_rx_arm(el_uart_t *u) {
+    int cur = u->dma_rx_active;
+    int next = cur ^ 1;
+
+    if (u->dma_rx_state[cur] == DMA_HALF_ARMED) {
+        return true;
+    }
+    if (u->dma_rx_state[next] != DMA_HALF_FREE) {
+        // Parsing is a whole half behind
+        return false;
+    }
+
+    u->dma_rx_active = next;
+    u->dma_rx_state[next] = DMA_HALF_ARMED;
+    if (uhci_receive(u->uhci, u->dma_rx_buf[next], u->dma_rx_buf_size) != ESP_OK) {
+        u->dma_rx_active = cur;
+        u->dma_rx_state[next] = DMA_HALF_FREE;
+        return false;
+    }
+    return true;
+}
+
+// Parse chunks in place as DMA fills one half while the other is consumed.
+// Does not return.
+static void uart_rx_dma_loop(el_uart_t *u) {
+    dma_rx_event_t ev;
+
+    // The first arm takes half 0
+    u->dma_rx_active = 1;
+    u->dma_rx_state[0] = DMA_HALF_FREE;
+    u->dma_rx_state[1] = DMA_HALF_FREE;
+    bool armed = dma_rx_arm(u);
+
+    while (1) {
+        // Retry a failed arm on a timer; with a half armed, chunks wake us
+        TickType_t wait = armed ? portMAX_DELAY : pdMS_TO_TICKS(DMA_RX_RETRY_MS);
+        if (xQueueReceive(u->dma_rx_queue, &ev, wait) == pdTRUE) {
+            dma_rx_arm(u);
+            uart_deliver(u, ev.data, ev.len);
+            if (ev.done) {
+                // Last chunk of its half: that half may be reused now
+                u->dma_rx_state[ev.half] = DMA_HALF_FREE;
+            }
+        }
+        armed = dma_rx_arm(u);
+        baud_run(u);
+    }
+}
 
-static uart_port_t uart_port = UART_NUM_1;
-static el_ctx_t *protocol_ctx = NULL;
-static TaskHandle_t rx_task_handle = NULL;
-static bool initialized = false;
+// Gather segments into the DMA TX buffer, one transfer per full buffer
+static int dma_writev(el_uart_t *u, const el_iovec_t *iov, size_t iovcnt) {
+    int written = 0;
+    size_t fill = 0;
+
+    xSemaphoreTake(u->dma_tx_lock, portMAX_DELAY);
+
+    for (size_t i = 0; i <= iovcnt; i++) {
+        const uint8_t *p = i < iovcnt ? iov[i].data : NULL;
+        size_t len = i < iovcnt ? iov[i].len : 0;
+
+        while (len > 0 || (i == iovcnt && fill > 0)) {
+            size_t n = DMA_TX_BUF_SIZE - fill;
+            if (n > len) {
+                n = len;
+            }
+            if (n > 0) {
+                memcpy(&u->dma_tx_buf[fill], p, n);
+                fill += n;
+                p += n;
+                len -= n;
+            }
+
+            // Flush when full, or at the end of the last segment
+            if (fill == DMA_TX_BUF_SIZE || (i == iovcnt && fill > 0)) {
+                if (uhci_transmit(u->uhci, u->dma_tx_buf, fill) != ESP_OK) {
+                    xSemaphoreGive(u->dma_tx_lock);
+                    return -1;
+                }
+                xSemaphoreTake(u->dma_tx_done, portMAX_DELAY);
+                written += fill;
+                fill = 0;
+            }
+        }
+    }
+
+    xSemaphoreGive(u->dma_tx_lock);
+    return written;
+}
+
+static void dma_free(el_uart_t *u) {
+    if (u->uhci) {
+        uhci_del_controller(u->uhci);
+        u->uhci = NULL;
+    }
+#if !EL_STATIC_ALLOC
+    for (int i = 0; i < 2; i++) {
+        heap_caps_free(u->dma_rx_buf[i]);
+    }
+    heap_caps_free(u->dma_tx_buf);
+#endif
+    u->dma_rx_buf[0] = u->dma_rx_buf[1] = NULL;
+    u->dma_tx_buf = NULL;
+    if (u->dma_rx_queue) {
+        vQueueDelete(u->dma_rx_queue);
+        u->dma_rx_queue = NULL;
+    }
+    if (u->dma_tx_done) {
+        vSemaphoreDelete(u->dma_tx_done);
+        u->dma_tx_done = NULL;
+    }
+    if (u->dma_tx_lock) {
+        vSemaphoreDelete(u->dma_tx_lock);
+        u->dma_tx_lock = NULL;
+    }
+}
+
+static esp_err_t dma_init(el_uart_t *u, const el_uart_config_t *config) {
+    u->dma_rx_buf_size = config->dma_rx_buf_size ? config->dma_rx_buf_size : DMA_RX_BUF_SIZE;
+
+#if EL_STATIC_ALLOC
+    const el_uart_storage_t *mem = config->storage;
+    u->dma_rx_buf[0] = mem->dma_rx_buf[0];
+    u->dma_rx_buf[1] = mem->dma_rx_buf[1];
+    u->dma_tx_buf = mem->dma_tx_buf;
+    u->dma_rx_queue = xQueueCreateStatic(DMA_RX_QUEUE_LEN, sizeof(dma_rx_event_t),
+                                         u->dma_rx_queue_storage, &u->dma_rx_queue_buf);
+    u->dma_tx_done = xSemaphoreCreateBinaryStatic(&u->dma_tx_done_buf);
+    u->dma_tx_lock = xSemaphoreCreateMutexStatic(&u->dma_tx_lock_buf);
+#else
+    for (int i = 0; i < 2; i++) {
+        u->dma_rx_buf[i] = heap_caps_malloc(u->dma_rx_buf_size,
+                                            MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    }
+    u->dma_tx_buf = heap_caps_malloc(DMA_TX_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    u->dma_rx_queue = xQueueCreate(DMA_RX_QUEUE_LEN, sizeof(dma_rx_event_t));
+    u->dma_tx_done = xSemaphoreCreateBinary();
+    u->dma_tx_lock = xSemaphoreCreateMutex();
+#endif
+
+    if (!u->dma_rx_buf[0] || !u->dma_rx_buf[1] || !u->dma_tx_buf || !u->dma_rx_queue ||
+        !u->dma_tx_done || !u->dma_tx_lock) {
+        ESP_LOGE(TAG, "Failed to allocate DMA buffers");
+        dma_free(u);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uhci_controller_config_t uhci_config = {
+        .uart_port = u->port,
+        .tx_trans_queue_depth = 1,
+        .max_transmit_size = DMA_TX_BUF_SIZE,
+        .max_receive_internal_mem = u->dma_rx_buf_size,
+        .dma_burst_size = 32,
+        .rx_eof_flags.idle_eof = 1,     // Report a chunk whenever the line goes idle
+    };
+
+    esp_err_t ret = uhci_new_controller(&uhci_config, &u->uhci);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create UHCI controller: %s", esp_err_to_name(ret));
+        dma_free(u);
+        return ret;
+    }
+
+    uhci_event_callbacks_t cbs = {
+        .on_rx_trans_event = dma_on_rx,
+        .on_tx_trans_done = dma_on_tx_done,
+    };
+    ret = uhci_register_event_callbacks(u->uhci, &cbs, u);
+    if (ret != ESP_OK) {
+        dma_free(u);
+    }
+    return ret;
+}
+#endif // EL_UART_HAVE_DMA
+
+// Write segments back to back through the active backend
+static int uart_writev(el_uart_t *u, const el_iovec_t *iov, size_t iovcnt) {
+#if EL_UART_HAVE_DMA
+    if (u->backend == EL_UART_BACKEND_DMA) {
+        return dma_writev(u, iov, iovcnt);
+    }
+#endif
+
+    // The driver copies into its TX ring, so segments go out back to back
+    int written = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        if (iov[i].len > 0) {
+            int n = uart_write_bytes(u->port, iov[i].data, iov[i].len);
+            if (n < 0) {
+                return -1;
+            }
+            written += n;
+        }
+    }
+    return written;
+}
 
 static void uart_rx_task(void *arg) {
-    uint8_t *data = malloc(UART_RX_BUF_SIZE);
-    if (!data) {
-        ESP_LOGE(TAG, "Failed to allocate RX buffer");
-        vTaskDelete(NULL);
-        return;
+    el_uart_t *u = arg;
+
+#if EL_UART_HAVE_DMA
+    if (u->backend == EL_UART_BACKEND_DMA) {
+        ESP_LOGI(TAG, "UART%d RX task started (DMA)", u->port);
+        uart_rx_dma_loop(u);
     }
+#endif
 
-    ESP_LOGI(TAG, "UART RX task started");
+    ESP_LOGI(TAG, "UART%d RX task started", u->port);
+
+    if (u->event_queue) {
+        uart_rx_event_loop(u);
+    }
 
     while (1) {
-        int len = uart_read_bytes(uart_port, data, UART_RX_BUF_SIZE,
+        int len = uart_read_bytes(u->port, u->rx_buf, u->rx_buf_size,
                                    pdMS_TO_TICKS(100));
-        if (len > 0 && protocol_ctx) {
-            el_process_bytes(protocol_ctx, data, len);
+        uart_deliver(u, u->rx_buf, len > 0 ? len : 0);
+        baud_run(u);
+    }
+}
+
+// Drains the protocol context's TX ring (asynchronous TX mode)
+static void uart_tx_task(void *arg) {
+    el_uart_t *u = arg;
+
+    ESP_LOGI(TAG, "UART%d TX task started", u->port);
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        el_iovec_t span[2];
+        size_t count;
+        while (el_tx_claim(u->protocol_ctx, span, &count) > 0) {
+            if (uart_writev(u, span, count) < 0) {
+                u->tx_failures++;
+            }
+            el_tx_release(u->protocol_ctx);
         }
     }
+}
 
-    free(data);
-    vTaskDelete(NULL);
+// Link part of el_get_stats for the protocol context
+static void uart_stats_hook(void *user, el_stats_t *stats) {
+    el_uart_t *u = user;
+
+    stats->link_rx_drops = u->rx_overflows;
+    stats->link_tx_drops = u->tx_failures;
+    if (u->dispatch) {
+        el_dispatch_stats_t ds;
+        el_dispatch_get_stats(u->dispatch, &ds);
+        stats->link_rx_drops += ds.overflows;
+        stats->link_queue_high_water = ds.high_water;
+    }
 }
 
-esp_err_t el_uart_init(const el_uart_config_t *config) {
-    if (!config) {
-        return ESP_ERR_INVALID_ARG;
+static void uart_tx_notify(void *user) {
+    xTaskNotifyGive((TaskHandle_t)user);
+}
+
+static void uart_tx_wait(void *user) {
+    vTaskDelay(1);
+}
+
+// Undo driver install / DMA setup for the active backend
+static esp_err_t uart_release(el_uart_t *u) {
+#if EL_UART_HAVE_DMA
+    if (u->backend == EL_UART_BACKEND_DMA) {
+        dma_free(u);
+        return ESP_OK;
     }
+#endif
+#if !EL_STATIC_ALLOC
+    heap_caps_free(u->rx_buf);
+#endif
+    u->rx_buf = NULL;
+    return uart_driver_delete(u->port);
+}
 
-    if (initialized) {
-        ESP_LOGW(TAG, "Already initialized");
+/*******************************************************************************
+ * Buffer and Task Placement
+ ******************************************************************************/
+
+#if !EL_STATIC_ALLOC
+// Falls back to any 8-bit capable heap when the requested one is exhausted
+static void *buf_alloc(el_uart_mem_t mem, size_t size) {
+    uint32_t caps = MALLOC_CAP_8BIT;
+
+    if (mem == EL_UART_MEM_INTERNAL) {
+        caps |= MALLOC_CAP_INTERNAL;
+    } else if (mem == EL_UART_MEM_SPIRAM) {
+        caps |= MALLOC_CAP_SPIRAM;
+    }
+
+    void *buf = heap_caps_malloc(size, caps);
+    if (!buf && mem != EL_UART_MEM_DEFAULT) {
+        ESP_LOGW(TAG, "No %s memory for %u-byte buffer, using default heap",
+                 mem == EL_UART_MEM_SPIRAM ? "PSRAM" : "internal", (unsigned)size);
+        buf = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    return buf;
+}
+#endif
+
+// stack/tcb are used with EL_STATIC_ALLOC only
+static BaseType_t task_create(const el_uart_config_t *config, TaskFunction_t fn, const char *name,
+                              uint32_t stack_size, UBaseType_t priority, el_uart_t *u,
+                              StackType_t *stack, StaticTask_t *tcb, TaskHandle_t *out) {
+    BaseType_t core = config->task_pinned ? (BaseType_t)config->task_core : UART_TASK_CORE;
+#if EL_STATIC_ALLOC
+    if (!stack) {
+        return pdFAIL;
+    }
+    *out = xTaskCreateStaticPinnedToCore(fn, name, stack_size, u, priority, stack, tcb, core);
+    return *out ? pdPASS : pdFAIL;
+#else
+    return xTaskCreatePinnedToCore(fn, name, stack_size, u, priority, out, core);
+#endif
+}
+
+static el_uart_t *instance_alloc(uart_port_t port) {
+#if EL_STATIC_ALLOC
+    if (port < 0 || port >= UART_NUM_MAX || uart_pool[port].in_use) {
+        return NULL;
+    }
+    el_uart_t *u = &uart_pool[port];
+    memset(u, 0, sizeof(*u));
+    u->in_use = true;
+    return u;
+#else
+    return calloc(1, sizeof(el_uart_t));
+#endif
+}
+
+static void instance_free(el_uart_t *u) {
+#if EL_STATIC_ALLOC
+    u->in_use = false;
+#else
+    free(u);
+#endif
+}
+
+/*******************************************************************************
+ * Baud Negotiation
+ ******************************************************************************/
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void baud_send(el_uart_t *u, uint8_t op, const uint8_t *arg, uint8_t arg_len) {
+    uint8_t msg[2 + 4];
+    msg[0] = EL_UART_BAUD_TAG;
+    msg[1] = op;
+    if (arg_len > 0) {
+        memcpy(&msg[2], arg, arg_len);
+    }
+    el_send(u->protocol_ctx, EL_MSG_VERSION, msg, (uint8_t)(2 + arg_len));
+}
+
+// Time to move one probe burst at rate, rounded up
+static uint32_t probe_time_ms(int rate) {
+    uint32_t bytes = BAUD_PROBE_COUNT * (EL_FRAME_OVERHEAD + BAUD_PROBE_LEN) + 16;
+    return (uint32_t)((uint64_t)bytes * 10 * 1000 / (uint32_t)rate) + 1;
+}
+
+static uint8_t probe_byte(uint8_t seq, size_t i) {
+    return (uint8_t)(seq * 29 + i * 37);
+}
+
+static void send_probes(el_uart_t *u) {
+    uint8_t probe[BAUD_PROBE_LEN];
+
+    for (uint8_t seq = 0; seq < BAUD_PROBE_COUNT; seq++) {
+        probe[0] = EL_UART_BAUD_TAG;
+        probe[1] = BAUD_PROBE;
+        probe[2] = seq;
+        for (size_t i = 3; i < sizeof(probe); i++) {
+            probe[i] = probe_byte(seq, i);
+        }
+        el_send(u->protocol_ctx, EL_MSG_VERSION, probe, sizeof(probe));
+    }
+
+    baud_send(u, BAUD_PROBE_END, NULL, 0);
+}
+
+// Let queued bytes leave the wire before changing its rate
+static void tx_drain(el_uart_t *u) {
+    // The TX task (ring mode) or DMA may still be handing bytes to the FIFO
+    vTaskDelay(pdMS_TO_TICKS(5));
+    if (u->backend == EL_UART_BACKEND_DRIVER) {
+        uart_wait_tx_done(u->port, pdMS_TO_TICKS(200));
+    }
+}
+
+static void switch_baud(el_uart_t *u, int rate) {
+    uart_set_baudrate(u->port, (uint32_t)rate);
+    u->baud = rate;
+    u->probes_ok = 0;
+    u->errors_base = u->protocol_ctx->rx_errors;
+    // Bytes caught mid-switch are garbage
+    uart_resync(u);
+}
+
+// Wake the RX task so it runs baud_run; the polling loop wakes every 100 ms
+// on its own
+static void baud_kick(el_uart_t *u) {
+#if EL_UART_HAVE_DMA
+    if (u->backend == EL_UART_BACKEND_DMA) {
+        dma_rx_event_t ev = { 0 };
+        xQueueSend(u->dma_rx_queue, &ev, 0);
+        return;
+    }
+#endif
+    if (u->event_queue) {
+        uart_event_t ev = { .type = UART_EVENT_MAX };
+        xQueueSend(u->event_queue, &ev, 0);
+    }
+}
+
+static void baud_post(el_uart_t *u, uint8_t work) {
+    __atomic_fetch_or(&u->baud_work, work, __ATOMIC_RELEASE);
+    baud_kick(u);
+}
+
+// Timer task: only flag the revert, the RX task owns the parser
+static void baud_revert(TimerHandle_t timer) {
+    baud_post(pvTimerGetTimerID(timer), BAUD_WORK_REVERT);
+}
+
+// Responder work; runs in the RX task after each read, in protocol order
+static void baud_run(el_uart_t *u) {
+    uint8_t work = __atomic_exchange_n(&u->baud_work, 0, __ATOMIC_ACQUIRE);
+
+    if ((work & BAUD_WORK_REVERT) && u->baud_fallback) {
+        int fallback = u->baud_fallback;
+        u->baud_fallback = 0;
+        ESP_LOGW(TAG, "UART%d: %d baud not confirmed, back to %d", u->port, u->baud, fallback);
+        switch_baud(u, fallback);
+    }
+
+    if ((work & BAUD_WORK_CONFIRM) && u->baud_fallback) {
+        xTimerStop(u->baud_timer, portMAX_DELAY);
+        u->baud_fallback = 0;
+        ESP_LOGI(TAG, "UART%d: now at %d baud", u->port, u->baud);
+    }
+
+    if (work & BAUD_WORK_SWITCH) {
+        int rate = u->baud_next;
+        uint8_t arg[4];
+        put_le32(arg, (uint32_t)rate);
+        baud_send(u, BAUD_ACCEPT, arg, sizeof(arg));
+        tx_drain(u);
+
+        xTimerStop(u->baud_timer, portMAX_DELAY);
+        // A revert flagged before the stop belongs to the previous rate
+        __atomic_fetch_and(&u->baud_work, (uint8_t)~BAUD_WORK_REVERT, __ATOMIC_RELAXED);
+        if (!u->baud_fallback) {
+            u->baud_fallback = u->baud;
+        }
+        switch_baud(u, rate);
+        // Changing the period also starts the timer
+        xTimerChangePeriod(u->baud_timer,
+                           pdMS_TO_TICKS(u->baud_revert_ms + 2 * probe_time_ms(rate)),
+                           portMAX_DELAY);
+    }
+
+    if ((work & BAUD_WORK_PROBES) && u->baud_fallback) {
+        send_probes(u);
+        baud_send(u, BAUD_REPORT, u->baud_report, sizeof(u->baud_report));
+    }
+}
+
+static esp_err_t baud_init(el_uart_t *u) {
+    // One-shot; the period is set when a switch arms it
+#if EL_STATIC_ALLOC
+    u->baud_q = xQueueCreateStatic(BAUD_QUEUE_LEN, sizeof(baud_event_t),
+                                   u->baud_q_storage, &u->baud_q_buf);
+    u->baud_timer = xTimerCreateStatic("el_uart_baud", pdMS_TO_TICKS(BAUD_REVERT_MS), pdFALSE,
+                                       u, baud_revert, &u->baud_timer_buf);
+#else
+    u->baud_q = xQueueCreate(BAUD_QUEUE_LEN, sizeof(baud_event_t));
+    u->baud_timer = xTimerCreate("el_uart_baud", pdMS_TO_TICKS(BAUD_REVERT_MS), pdFALSE,
+                                 u, baud_revert);
+#endif
+    return u->baud_q && u->baud_timer ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static void baud_free(el_uart_t *u) {
+    if (u->baud_timer) {
+        xTimerDelete(u->baud_timer, portMAX_DELAY);
+        u->baud_timer = NULL;
+    }
+    if (u->baud_q) {
+        vQueueDelete(u->baud_q);
+        u->baud_q = NULL;
+    }
+}
+
+// Wait for a reply; false on timeout or a different reply (REJECT)
+static bool baud_wait(el_uart_t *u, uint8_t op, uint32_t timeout_ms, baud_event_t *ev) {
+    if (xQueueReceive(u->baud_q, ev, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return false;
+    }
+    return ev->op == op;
+}
+
+bool el_uart_handle_message(el_uart_t *u, uint8_t msg_id, const void *payload, uint8_t len) {
+    const uint8_t *p = payload;
+
+    if (!u || !u->protocol_ctx || msg_id != EL_MSG_VERSION || len < 2 || p[0] != EL_UART_BAUD_TAG) {
+        return false;
+    }
+
+    baud_event_t ev = { .op = p[1] };
+
+    switch (p[1]) {
+        // Responder side
+        case BAUD_PROPOSE: {
+            if (len != 6) {
+                break;
+            }
+            int rate = (int)get_le32(&p[2]);
+            if (rate <= 0 || (u->max_baud && rate > u->max_baud)) {
+                baud_send(u, BAUD_REJECT, NULL, 0);
+                break;
+            }
+
+            u->baud_next = rate;
+            baud_post(u, BAUD_WORK_SWITCH);
+            break;
+        }
+
+        case BAUD_PROBE:
+            if (len == BAUD_PROBE_LEN) {
+                for (size_t i = 3; i < len; i++) {
+                    if (p[i] != probe_byte(p[2], i)) {
+                        return true;
+                    }
+                }
+                u->probes_ok++;
+            }
+            break;
+
+        case BAUD_PROBE_END: {
+            if (!u->baud_fallback) {
+                break;
+            }
+            // Count now, in parse order; the probes go out from the RX task
+            uint16_t ok = u->probes_ok;
+            uint32_t errors = u->protocol_ctx->rx_errors - u->errors_base;
+            u->baud_report[0] = (uint8_t)ok;
+            u->baud_report[1] = (uint8_t)(ok >> 8);
+            u->baud_report[2] = (uint8_t)(errors > 0xFFFF ? 0xFF : errors);
+            u->baud_report[3] = (uint8_t)(errors > 0xFFFF ? 0xFF : errors >> 8);
+            baud_post(u, BAUD_WORK_PROBES);
+            break;
+        }
+
+        case BAUD_CONFIRM:
+            baud_post(u, BAUD_WORK_CONFIRM);
+            break;
+
+        // Initiator side: hand to el_uart_negotiate_baud
+        case BAUD_ACCEPT:
+            if (len == 6) {
+                ev.a = get_le32(&p[2]);
+                xQueueSend(u->baud_q, &ev, 0);
+            }
+            break;
+
+        case BAUD_REJECT:
+            xQueueSend(u->baud_q, &ev, 0);
+            break;
+
+        case BAUD_REPORT:
+            if (len == 6) {
+                ev.a = (uint32_t)p[2] | ((uint32_t)p[3] << 8);
+                ev.b = (uint32_t)p[4] | ((uint32_t)p[5] << 8);
+                xQueueSend(u->baud_q, &ev, 0);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+void el_uart_baud_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len) {
+    el_uart_handle_message((el_uart_t *)user, msg_id, payload, len);
+}
+
+esp_err_t el_uart_negotiate_baud(el_uart_t *u, const int *rates, size_t count, int *out_baud) {
+    if (!u || !rates || !out_baud) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!u->protocol_ctx) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    uart_port = config->port;
-    protocol_ctx = config->protocol_ctx;
+    int good = u->baud;
+    xQueueReset(u->baud_q);
+
+    for (size_t i = 0; i < count; i++) {
+        int rate = rates[i];
+        if (rate <= good) {
+            continue;
+        }
+
+        uint8_t arg[4];
+        put_le32(arg, (uint32_t)rate);
+        baud_send(u, BAUD_PROPOSE, arg, sizeof(arg));
+
+        baud_event_t ev;
+        if (!baud_wait(u, BAUD_ACCEPT, BAUD_ACCEPT_MS, &ev) || ev.a != (uint32_t)rate) {
+            // Declined or unanswered: the peer is still at the old rate
+            break;
+        }
+
+        switch_baud(u, rate);
+        vTaskDelay(pdMS_TO_TICKS(BAUD_SETTLE_MS));
+        send_probes(u);
+
+        bool clean = baud_wait(u, BAUD_REPORT, BAUD_ACCEPT_MS + 2 * probe_time_ms(rate), &ev) &&
+                     ev.a == BAUD_PROBE_COUNT && ev.b == 0 &&
+                     u->probes_ok == BAUD_PROBE_COUNT &&
+                     u->protocol_ctx->rx_errors == u->errors_base;
+
+        if (!clean) {
+            ESP_LOGW(TAG, "UART%d: %d baud not clean, staying at %d", u->port, rate, good);
+            tx_drain(u);
+            switch_baud(u, good);
+            // Give the peer's revert timer time to fire
+            vTaskDelay(pdMS_TO_TICKS(u->baud_revert_ms + 2 * probe_time_ms(rate)));
+            xQueueReset(u->baud_q);
+            break;
+        }
+
+        baud_send(u, BAUD_CONFIRM, NULL, 0);
+        good = rate;
+        ESP_LOGI(TAG, "UART%d: %d baud clean", u->port, rate);
+    }
+
+    *out_baud = good;
+    return ESP_OK;
+}
+
+esp_err_t el_uart_set_baud(el_uart_t *uart, int baud) {
+    if (!uart || baud <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = uart_set_baudrate(uart->port, (uint32_t)baud);
+    if (ret == ESP_OK) {
+        uart->baud = baud;
+    }
+    return ret;
+}
+
+/*******************************************************************************
+ * Instance API
+ ******************************************************************************/
+
+esp_err_t el_uart_create(const el_uart_config_t *config, el_uart_t **out) {
+    if (!config || !out || (unsigned)config->flow_ctrl > EL_UART_FLOW_RTS_CTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if !EL_UART_HAVE_DMA
+    if (config->backend == EL_UART_BACKEND_DMA) {
+        ESP_LOGE(TAG, "DMA backend not supported on this target");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+
+#if EL_STATIC_ALLOC
+    if (!config->storage) {
+        ESP_LOGE(TAG, "EL_STATIC_ALLOC: config->storage is required");
+        return ESP_ERR_INVALID_ARG;
+    }
+#endif
+
+    el_uart_t *u = instance_alloc(config->port);
+    if (!u) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    u->port = config->port;
+    u->protocol_ctx = config->protocol_ctx;
+    u->dispatch = config->dispatch;
+    u->backend = config->backend;
+    u->baud = config->baud_rate;
+    u->max_baud = config->max_baud;
+    u->baud_revert_ms = config->baud_revert_ms ? config->baud_revert_ms : BAUD_REVERT_MS;
+    u->rx_buf_size = config->rx_buf_size ? config->rx_buf_size : UART_RX_BUF_SIZE;
+
+    size_t tx_buf_size = config->tx_buf_size ? config->tx_buf_size : UART_TX_BUF_SIZE;
+    uint32_t rx_stack = config->rx_task_stack_size ? config->rx_task_stack_size : RX_TASK_STACK_SIZE;
+    UBaseType_t rx_prio = config->rx_task_priority ? config->rx_task_priority : RX_TASK_PRIORITY;
+    uint32_t tx_stack = config->tx_task_stack_size ? config->tx_task_stack_size : TX_TASK_STACK_SIZE;
+    UBaseType_t tx_prio = config->tx_task_priority ? config->tx_task_priority : TX_TASK_PRIORITY;
+    StackType_t *rx_stack_mem = NULL;
+    StackType_t *tx_stack_mem = NULL;
+    StaticTask_t *rx_tcb = NULL;
+    StaticTask_t *tx_tcb = NULL;
+
+#if EL_STATIC_ALLOC
+    u->rx_buf_size = config->storage->rx_buf_size;
+    rx_stack = config->storage->rx_task_stack_size;
+    tx_stack = config->storage->tx_task_stack_size;
+    rx_stack_mem = config->storage->rx_task_stack;
+    tx_stack_mem = config->storage->tx_task_stack;
+    rx_tcb = &u->rx_task_buf;
+    tx_tcb = &u->tx_task_buf;
+#endif
+
+    esp_err_t ret = baud_init(u);
+    if (ret != ESP_OK) {
+        baud_free(u);
+        instance_free(u);
+        return ret;
+    }
+
+    static const uart_hw_flowcontrol_t flow_modes[] = {
+        [EL_UART_FLOW_NONE] = UART_HW_FLOWCTRL_DISABLE,
+        [EL_UART_FLOW_RTS] = UART_HW_FLOWCTRL_RTS,
+        [EL_UART_FLOW_CTS] = UART_HW_FLOWCTRL_CTS,
+        [EL_UART_FLOW_RTS_CTS] = UART_HW_FLOWCTRL_CTS_RTS,
+    };
+    bool use_rts = config->flow_ctrl == EL_UART_FLOW_RTS || config->flow_ctrl == EL_UART_FLOW_RTS_CTS;
+    bool use_cts = config->flow_ctrl == EL_UART_FLOW_CTS || config->flow_ctrl == EL_UART_FLOW_RTS_CTS;
 
     // UART configuration
     uart_config_t uart_config = {
@@ -63,63 +1021,121 @@ esp_err_t el_uart_init(const el_uart_config_t *config) {
         .data_bits = UART_DATA_8_BITS,
         .parity = UART_PARITY_DISABLE,
         .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .flow_ctrl = flow_modes[config->flow_ctrl],
+        .rx_flow_ctrl_thresh = config->rx_flow_thresh ? config->rx_flow_thresh : RX_FLOW_THRESH,
         .source_clk = UART_SCLK_DEFAULT,
     };
 
-    esp_err_t ret = uart_driver_install(uart_port, UART_RX_BUF_SIZE,
-                                         UART_TX_BUF_SIZE, 0, NULL, 0);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to install UART driver: %s", esp_err_to_name(ret));
-        return ret;
+    if (u->backend == EL_UART_BACKEND_DRIVER) {
+#if EL_STATIC_ALLOC
+        u->rx_buf = config->storage->rx_buf;
+#else
+        u->rx_buf = buf_alloc(config->buffer_mem, u->rx_buf_size);
+#endif
+        if (!u->rx_buf) {
+            ESP_LOGE(TAG, "Failed to allocate RX buffer");
+            baud_free(u);
+            instance_free(u);
+            return ESP_ERR_NO_MEM;
+        }
+
+        // The driver's ring buffers always live in internal RAM
+        ret = uart_driver_install(u->port, u->rx_buf_size, tx_buf_size,
+                                  config->rx_event_driven ? UART_EVENT_QUEUE_LEN : 0,
+                                  config->rx_event_driven ? &u->event_queue : NULL, 0);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to install UART driver: %s", esp_err_to_name(ret));
+#if !EL_STATIC_ALLOC
+            heap_caps_free(u->rx_buf);
+#endif
+            baud_free(u);
+            instance_free(u);
+            return ret;
+        }
+
+        if (config->rx_full_thresh > 0) {
+            uart_set_rx_full_threshold(u->port, config->rx_full_thresh);
+        }
+        if (config->rx_timeout > 0) {
+            uart_set_rx_timeout(u->port, config->rx_timeout);
+        }
     }
 
-    ret = uart_param_config(uart_port, &uart_config);
+    ret = uart_param_config(u->port, &uart_config);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to configure UART: %s", esp_err_to_name(ret));
-        uart_driver_delete(uart_port);
-        return ret;
+        goto fail;
     }
 
     // Set pins if specified
     int tx_pin = config->tx_pin >= 0 ? config->tx_pin : UART_PIN_NO_CHANGE;
     int rx_pin = config->rx_pin >= 0 ? config->rx_pin : UART_PIN_NO_CHANGE;
+    int rts_pin = use_rts && config->rts_pin >= 0 ? config->rts_pin : UART_PIN_NO_CHANGE;
+    int cts_pin = use_cts && config->cts_pin >= 0 ? config->cts_pin : UART_PIN_NO_CHANGE;
 
-    ret = uart_set_pin(uart_port, tx_pin, rx_pin,
-                       UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    ret = uart_set_pin(u->port, tx_pin, rx_pin, rts_pin, cts_pin);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set UART pins: %s", esp_err_to_name(ret));
-        uart_driver_delete(uart_port);
-        return ret;
+        goto fail;
     }
 
+#if EL_UART_HAVE_DMA
+    if (u->backend == EL_UART_BACKEND_DMA) {
+        ret = dma_init(u, config);
+        if (ret != ESP_OK) {
+            baud_free(u);
+            instance_free(u);
+            return ret;
+        }
+    }
+#endif
+
     // Create RX task
-    BaseType_t task_ret = xTaskCreate(uart_rx_task, "el_uart_rx",
-                                       RX_TASK_STACK_SIZE, NULL,
-                                       RX_TASK_PRIORITY, &rx_task_handle);
+    BaseType_t task_ret = task_create(config, uart_rx_task, "el_uart_rx", rx_stack, rx_prio, u,
+                                      rx_stack_mem, rx_tcb, &u->rx_task_handle);
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create RX task");
-        uart_driver_delete(uart_port);
-        return ESP_FAIL;
+        ret = ESP_FAIL;
+        goto fail;
+    }
+
+    // Asynchronous TX: drain the context's TX ring from a sender task
+    if (u->protocol_ctx && el_tx_async(u->protocol_ctx)) {
+        task_ret = task_create(config, uart_tx_task, "el_uart_tx", tx_stack, tx_prio, u,
+                               tx_stack_mem, tx_tcb, &u->tx_task_handle);
+        if (task_ret != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create TX task");
+            vTaskDelete(u->rx_task_handle);
+            ret = ESP_FAIL;
+            goto fail;
+        }
+        el_tx_attach(u->protocol_ctx, uart_tx_notify, uart_tx_wait, u->tx_task_handle);
+    }
+
+    if (u->protocol_ctx) {
+        el_set_stats_hook(u->protocol_ctx, uart_stats_hook, u);
     }
 
-    initialized = true;
     ESP_LOGI(TAG, "Etherlink UART initialized on port %d, baud %d",
-             uart_port, config->baud_rate);
+             u->port, config->baud_rate);
 
+    *out = u;
     return ESP_OK;
-}
 
-void el_uart_send_raw(const uint8_t *data, size_t len) {
-    el_uart_send(data, len);
+fail:
+    uart_release(u);
+    baud_free(u);
+    instance_free(u);
+    return ret;
 }
 
-esp_err_t el_uart_send(const uint8_t *data, size_t len) {
-    if (!initialized) {
+esp_err_t el_uart_write(el_uart_t *uart, const uint8_t *data, size_t len) {
+    if (!uart) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    int written = uart_write_bytes(uart_port, data, len);
+    el_iovec_t seg = { .data = data, .len = len };
+    int written = uart_writev(uart, &seg, 1);
     if (written < 0) {
         return ESP_FAIL;
     }
@@ -127,25 +1143,80 @@ esp_err_t el_uart_send(const uint8_t *data, size_t len) {
     return ESP_OK;
 }
 
-esp_err_t el_uart_deinit(void) {
-    if (!initialized) {
-        return ESP_ERR_INVALID_STATE;
+void el_uart_send_rawv(void *user, const el_iovec_t *iov, size_t iovcnt) {
+    el_uart_t *u = user ? user : default_uart;
+
+    if (!u) {
+        return;
+    }
+
+    if (uart_writev(u, iov, iovcnt) < 0) {
+        u->tx_failures++;
+    }
+}
+
+esp_err_t el_uart_delete(el_uart_t *uart) {
+    if (!uart) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (rx_task_handle) {
-        vTaskDelete(rx_task_handle);
-        rx_task_handle = NULL;
+    if (uart->rx_task_handle) {
+        vTaskDelete(uart->rx_task_handle);
+        uart->rx_task_handle = NULL;
     }
 
-    esp_err_t ret = uart_driver_delete(uart_port);
+    if (uart->protocol_ctx) {
+        el_set_stats_hook(uart->protocol_ctx, NULL, NULL);
+    }
+
+    if (uart->tx_task_handle) {
+        el_tx_attach(uart->protocol_ctx, NULL, NULL, NULL);
+        vTaskDelete(uart->tx_task_handle);
+        uart->tx_task_handle = NULL;
+    }
+
+    baud_free(uart);
+
+    esp_err_t ret = uart_release(uart);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to delete UART driver: %s", esp_err_to_name(ret));
         return ret;
     }
 
-    protocol_ctx = NULL;
-    initialized = false;
-
-    ESP_LOGI(TAG, "Etherlink UART deinitialized");
+    ESP_LOGI(TAG, "Etherlink UART%d deinitialized", uart->port);
+    instance_free(uart);
     return ESP_OK;
 }
+
+/*******************************************************************************
+ * Single-Port API
+ ******************************************************************************/
+
+esp_err_t el_uart_init(const el_uart_config_t *config) {
+    if (default_uart) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return el_uart_create(config, &default_uart);
+}
+
+void el_uart_send_raw(const uint8_t *data, size_t len) {
+    el_uart_send(data, len);
+}
+
+esp_err_t el_uart_send(const uint8_t *data, size_t len) {
+    return el_uart_write(default_uart, data, len);
+}
+
+esp_err_t el_uart_deinit(void) {
+    if (!default_uart) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = el_uart_delete(default_uart);
+    if (ret == ESP_OK) {
+        default_uart = NULL;
+    }
+    return ret;
+}
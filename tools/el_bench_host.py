@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""
+Etherlink benchmark peer
+
+Host side of etherlink_bench, over a serial port or BLE (Nordic UART
+Service):
+
+    el_bench_host.py echo --port /dev/ttyUSB0 --baud 921600
+    el_bench_host.py echo --ble etherlink-dev
+    el_bench_host.py ping --ble etherlink-dev --sizes 0,64,250 --frames 500
+    el_bench_host.py stats --port /dev/ttyUSB0
+
+echo answers every EL_MSG_PING with an EL_MSG_PONG carrying the same
+payload, so el_bench_run on the device can measure against the host.
+ping runs the measurement from the host against a device whose context
+has auto_pong set, and prints the same columns as el_bench_print. RTTs
+here include the host's USB or Bluetooth stack. stats polls a device
+whose context has auto_stats set with EL_MSG_STATS once a second and
+prints its counters.
+
+Needs pyserial for --port and bleak for --ble.
+
+MIT License - https://github.com/user/etherlink
+"""
+
+import argparse
+import asyncio
+import statistics
+import struct
+import sys
+import time
+
+SYNC_BYTE = 0xA5
+MAX_PAYLOAD = 250
+MSG_PING = 0x00
+MSG_PONG = 0x01
+MSG_STATS = 0x0A
+
+STATS_VERSION = 1
+STATS_FIELDS = ('rx_frames', 'rx_bytes', 'rx_crc_errors', 'rx_len_errors',
+                'rx_sync_discarded', 'rx_unhandled', 'rx_bad_length', 'rx_filtered',
+                'tx_frames', 'tx_bytes', 'tx_drops', 'tx_high_water',
+                'rx_cb_max', 'link_rx_drops', 'link_tx_drops', 'link_queue_high_water')
+
+NUS_RX_UUID = '6e400002-b5a3-f393-e0a9-e50e24dcca9e'   # Host writes
+NUS_TX_UUID = '6e400003-b5a3-f393-e0a9-e50e24dcca9e'   # Device notifies
+
+
+def crc8(data, crc=0):
+    """CRC-8, polynomial 0x07, as used by Etherlink frames."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(msg_id, payload):
+    header = bytes((msg_id, len(payload)))
+    return bytes((SYNC_BYTE,)) + header + bytes(payload) + bytes((crc8(header + bytes(payload)),))
+
+
+class Parser:
+    """Incremental frame parser; feed() yields (msg_id, payload)."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.errors = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            start = self.buf.find(SYNC_BYTE)
+            if start < 0:
+                self.buf.clear()
+                return
+            del self.buf[:start]
+            if len(self.buf) < 3:
+                return
+            length = self.buf[2]
+            if length > MAX_PAYLOAD:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+            if len(self.buf) < length + 4:
+                return
+            body = bytes(self.buf[1:3 + length])
+            if crc8(body) != self.buf[3 + length]:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+            del self.buf[:length + 4]
+            yield body[0], body[2:]
+
+
+class SerialLink:
+    def __init__(self, port, baud):
+        import serial
+        self.ser = serial.Serial(port, baud, timeout=0.05)
+        self.rx = asyncio.Queue()
+
+    async def start(self):
+        loop = asyncio.get_running_loop()
+
+        def reader():
+            while self.ser.is_open:
+                data = self.ser.read(4096)
+                if data:
+                    loop.call_soon_threadsafe(self.rx.put_nowait, data)
+
+        loop.run_in_executor(None, reader)
+
+    async def write(self, data):
+        self.ser.write(data)
+
+    async def close(self):
+        self.ser.close()
+
+
+class BleLink:
+    def __init__(self, name):
+        self.name = name
+        self.rx = asyncio.Queue()
+        self.client = None
+        self.chunk = 20
+
+    async def start(self):
+        from bleak import BleakClient, BleakScanner
+        device = await BleakScanner.find_device_by_filter(
+            lambda d, _: d.name == self.name or d.address.lower() == self.name.lower())
+        if device is None:
+            sys.exit(f'{self.name}: not found')
+        self.client = BleakClient(device)
+        await self.client.connect()
+        char = self.client.services.get_characteristic(NUS_RX_UUID)
+        self.chunk = char.max_write_without_response_size
+        await self.client.start_notify(NUS_TX_UUID, lambda _, data: self.rx.put_nowait(bytes(data)))
+
+    async def write(self, data):
+        for i in range(0, len(data), self.chunk):
+            await self.client.write_gatt_char(NUS_RX_UUID, data[i:i + self.chunk], response=False)
+
+    async def close(self):
+        await self.client.disconnect()
+
+
+async def echo(link):
+    parser = Parser()
+    answered = 0
+    last = time.monotonic()
+    while True:
+        data = await link.rx.get()
+        for msg_id, payload in parser.feed(data):
+            if msg_id == MSG_PING:
+                await link.write(frame(MSG_PONG, payload))
+                answered += 1
+        if time.monotonic() - last >= 1.0:
+            print(f'{answered} PONGs sent, {parser.errors} bad frames', flush=True)
+            last = time.monotonic()
+
+
+async def ping_run(link, size, frames, window, timeout):
+    """One run: returns (sent, rtts in us, elapsed s)."""
+    parser = Parser()
+    pending = {}
+    rtts = []
+    window = window if size >= 2 else 1
+    sent = 0
+    start = time.perf_counter()
+
+    while sent < frames or pending:
+        while sent < frames and len(pending) < window:
+            seq = sent & 0xFFFF
+            payload = bytes((seq & 0xFF, seq >> 8)) + bytes((i * 37) & 0xFF for i in range(2, size))
+            pending[seq if size >= 2 else 0] = time.perf_counter()
+            await link.write(frame(MSG_PING, payload[:size]))
+            sent += 1
+        try:
+            data = await asyncio.wait_for(link.rx.get(), timeout)
+        except asyncio.TimeoutError:
+            pending.clear()
+            continue
+        now = time.perf_counter()
+        for msg_id, payload in parser.feed(data):
+            if msg_id != MSG_PONG or len(payload) != size:
+                continue
+            seq = payload[0] | (payload[1] << 8) if size >= 2 else 0
+            t0 = pending.pop(seq, None)
+            if t0 is not None:
+                rtts.append((now - t0) * 1e6)
+        for seq, t0 in list(pending.items()):
+            if now - t0 > timeout:
+                del pending[seq]
+
+    return sent, rtts, time.perf_counter() - start
+
+
+async def ping(link, sizes, frames, window, timeout):
+    print(' len   sent   lost  frames/s  goodput B/s  rtt min/p50/p99/max us')
+    for size in sizes:
+        sent, rtts, elapsed = await ping_run(link, size, frames, window, timeout)
+        if rtts:
+            rtts.sort()
+            p50 = statistics.median(rtts)
+            p99 = rtts[min(len(rtts) - 1, int(len(rtts) * 0.99))]
+            rtt = f'{rtts[0]:.0f}/{p50:.0f}/{p99:.0f}/{rtts[-1]:.0f}'
+        else:
+            rtt = '-'
+        fps = len(rtts) / elapsed
+        print(f'{size:4} {sent:6} {sent - len(rtts):6} {fps:9.0f} {fps * size * 2:12.0f}  {rtt}',
+              flush=True)
+
+
+async def stats(link, interval):
+    parser = Parser()
+    while True:
+        await link.write(frame(MSG_STATS, b''))
+        deadline = time.monotonic() + interval
+        while (left := deadline - time.monotonic()) > 0:
+            try:
+                data = await asyncio.wait_for(link.rx.get(), left)
+            except asyncio.TimeoutError:
+                break
+            for msg_id, payload in parser.feed(data):
+                if (msg_id != MSG_STATS or len(payload) < 1 + 4 * len(STATS_FIELDS)
+                        or payload[0] != STATS_VERSION):
+                    continue
+                values = struct.unpack_from(f'<{len(STATS_FIELDS)}I', payload, 1)
+                print('  '.join(f'{k}={v}' for k, v in zip(STATS_FIELDS, values)), flush=True)
+
+
+async def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('mode', choices=('echo', 'ping', 'stats'))
+    link_group = ap.add_mutually_exclusive_group(required=True)
+    link_group.add_argument('--port', help='serial port')
+    link_group.add_argument('--ble', help='BLE device name or address')
+    ap.add_argument('--baud', type=int, default=115200)
+    ap.add_argument('--sizes', default='0,1,16,32,64,128,200,250',
+                    help='payload sizes for ping (comma separated)')
+    ap.add_argument('--frames', type=int, default=1000, help='PINGs per size')
+    ap.add_argument('--window', type=int, default=8, help='PINGs in flight')
+    ap.add_argument('--timeout', type=float, default=1.0, help='seconds before a PING is lost')
+    ap.add_argument('--interval', type=float, default=1.0, help='seconds between stats requests')
+    args = ap.parse_args()
+
+    link = SerialLink(args.port, args.baud) if args.port else BleLink(args.ble)
+    await link.start()
+    try:
+        if args.mode == 'echo':
+            await echo(link)
+        elif args.mode == 'stats':
+            await stats(link, args.interval)
+        else:
+            sizes = [int(s) for s in args.sizes.split(',')]
+            if any(s < 0 or s > MAX_PAYLOAD for s in sizes):
+                sys.exit(f'sizes must be 0-{MAX_PAYLOAD}')
+            await ping(link, sizes, args.frames, args.window, args.timeout)
+    finally:
+        await link.close()
+
+
+if __name__ == '__main__':
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+"""
+Etherlink schema decoder generator
+
+Reads a C header that declares an Etherlink message table for
+etherlink_schema.h and writes a Python module that encodes and decodes
+the same messages on the host:
+
+    el_schema_gen.py my_messages.h --list MY_MESSAGES -o my_messages.py
+
+    import my_messages
+    parser = my_messages.Parser()
+    for name, fields in parser.feed(serial_port.read(256)):
+        print(name, fields)
+    port.write(my_messages.encode('set_led', led=3, on=1))
+
+Payload structs may be plain typedef'd structs (natural alignment, the
+padding is reproduced) or EL_PACKED_STRUCT(...). Fields must be fixed-size
+integer, float, double or bool scalars, or one-dimensional arrays of them;
+char arrays decode as bytes.
+
+MIT License - https://github.com/user/etherlink
+"""
+
+import argparse
+import re
+import sys
+
+# C type -> (struct format char, size)
+SCALARS = {
+    'uint8_t': ('B', 1), 'int8_t': ('b', 1), 'char': ('s', 1),
+    'bool': ('?', 1), '_Bool': ('?', 1),
+    'uint16_t': ('H', 2), 'int16_t': ('h', 2),
+    'uint32_t': ('I', 4), 'int32_t': ('i', 4), 'float': ('f', 4),
+    'uint64_t': ('Q', 8), 'int64_t': ('q', 8), 'double': ('d', 8),
+}
+
+ENTRY_RE = re.compile(r'X\(\s*(0[xX][0-9a-fA-F]+|\d+)\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(TX|RX|BOTH)\s*\)')
+LIST_RE = re.compile(r'#\s*define\s+(\w+)\s*\(\s*X\s*\)(.*)')
+TYPEDEF_RE = re.compile(r'typedef\s+struct\s*(?:\w+\s*)?\{([^{}]*)\}\s*(\w+)\s*;', re.S)
+PACKED_RE = re.compile(r'EL_PACKED_STRUCT\(\s*(\w+)\s*,\s*\{([^{}]*)\}\s*\)', re.S)
+FIELD_RE = re.compile(r'^(?:const\s+)?(\w+)\s+(\w+)\s*(?:\[\s*(\d+)\s*\])?$')
+
+
+class SchemaError(Exception):
+    pass
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', ' ', text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def parse_fields(type_name, body):
+    fields = []
+    for decl in body.split(';'):
+        decl = ' '.join(decl.split())
+        if not decl:
+            continue
+        m = FIELD_RE.match(decl)
+        if not m or m.group(1) not in SCALARS:
+            raise SchemaError(f'{type_name}: unsupported field "{decl}"')
+        fields.append((m.group(2), m.group(1), int(m.group(3) or 1)))
+    return fields
+
+
+def layout(fields, packed):
+    """Return (struct format, field list) for the wire image of a struct."""
+    fmt = '<'
+    offset = 0
+    max_align = 1
+    for name, ctype, count in fields:
+        code, size = SCALARS[ctype]
+        if not packed:
+            pad = -offset % size
+            fmt += 'x' * pad
+            offset += pad
+            max_align = max(max_align, size)
+        fmt += f'{count}s' if code == 's' else (code if count == 1 else f'{count}{code}')
+        offset += size * count
+    if not packed:
+        fmt += 'x' * (-offset % max_align)
+    return fmt
+
+
+def parse_header(text, list_name):
+    text = strip_comments(text).replace('\\\n', ' ')
+
+    structs = {}
+    for body, name in TYPEDEF_RE.findall(text):
+        structs[name] = (parse_fields(name, body), False)
+    for name, body in PACKED_RE.findall(text):
+        structs[name] = (parse_fields(name, body), True)
+
+    tables = {m.group(1): m.group(2) for m in LIST_RE.finditer(text)}
+    if not tables:
+        raise SchemaError('no message table (#define NAME(X) ...) found')
+    if list_name is None:
+        list_name = next(iter(tables))
+    if list_name not in tables:
+        raise SchemaError(f'message table {list_name} not found')
+
+    messages = []
+    seen = {}
+    for ident, name, ctype, direction in ENTRY_RE.findall(tables[list_name]):
+        msg_id = int(ident, 0)
+        if msg_id in seen:
+            raise SchemaError(f'{name}: id 0x{msg_id:02X} already used by {seen[msg_id]}')
+        if ctype not in structs:
+            raise SchemaError(f'{name}: struct {ctype} not found')
+        seen[msg_id] = name
+        fields, packed = structs[ctype]
+        # Values per field after unpacking (a char array is one bytes value)
+        counts = [(f, 1 if t == 'char' else c) for f, t, c in fields]
+        messages.append((msg_id, name, direction, layout(fields, packed), counts))
+    return list_name, messages
+
+
+PRELUDE = '''\
+# Generated by el_schema_gen.py from {source} ({table}) - do not edit
+
+import struct
+from collections import namedtuple
+
+SYNC_BYTE = 0xA5
+MAX_PAYLOAD = 250
+
+Message = namedtuple('Message', 'id name direction layout fields')
+
+
+def crc8(data, crc=0):
+    """CRC-8, polynomial 0x07, as used by Etherlink frames."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+'''
+
+FUNCTIONS = '''
+
+BY_ID = {{m.id: m for m in MESSAGES}}
+BY_NAME = {{m.name: m for m in MESSAGES}}
+
+
+def decode(msg_id, payload):
+    """Decode a payload into (name, fields dict); unknown IDs give (None, payload)."""
+    msg = BY_ID.get(msg_id)
+    if msg is None or len(payload) != msg.layout.size:
+        return None, bytes(payload)
+    values = iter(msg.layout.unpack(payload))
+    fields = {{}}
+    for name, count in msg.fields:
+        fields[name] = next(values) if count == 1 else tuple(next(values) for _ in range(count))
+    return msg.name, fields
+
+
+def encode_payload(name, **fields):
+    msg = BY_NAME[name]
+    values = []
+    for field, count in msg.fields:
+        value = fields[field]
+        if count == 1:
+            values.append(value)
+        else:
+            values.extend(value)
+    return msg.layout.pack(*values)
+
+
+def frame(msg_id, payload):
+    """Wrap a payload in an Etherlink frame."""
+    header = bytes((msg_id, len(payload)))
+    return bytes((SYNC_BYTE,)) + header + bytes(payload) + bytes((crc8(header + bytes(payload)),))
+
+
+def encode(name, **fields):
+    """Build a complete frame for a message."""
+    return frame(BY_NAME[name].id, encode_payload(name, **fields))
+
+
+class Parser:
+    """Incremental frame parser; feed() yields (name, fields) per valid frame."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.errors = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            start = self.buf.find(SYNC_BYTE)
+            if start < 0:
+                self.buf.clear()
+                return
+            del self.buf[:start]
+            if len(self.buf) < 3:
+                return
+            length = self.buf[2]
+            if length > MAX_PAYLOAD:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+            if len(self.buf) < length + 4:
+                return
+            body = bytes(self.buf[1:3 + length])
+            if crc8(body) != self.buf[3 + length]:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+            del self.buf[:length + 4]
+            name, fields = decode(body[0], body[2:])
+            yield (name if name else body[0]), fields
+'''
+
+
+def generate(source, table, messages):
+    out = [PRELUDE.format(source=source, table=table)]
+    out.append('MESSAGES = [\n')
+    for msg_id, name, direction, fmt, fields in messages:
+        out.append(f"    Message(0x{msg_id:02X}, '{name}', '{direction}', struct.Struct('{fmt}'),\n"
+                   f"            {tuple(fields)!r}),\n")
+    out.append(']\n')
+    out.append(FUNCTIONS.format())
+    return ''.join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('header', help='C header declaring the message table')
+    ap.add_argument('--list', help='X-macro table name (default: first found)')
+    ap.add_argument('-o', '--output', help='Output .py file (default: stdout)')
+    args = ap.parse_args()
+
+    with open(args.header) as f:
+        text = f.read()
+
+    try:
+        table, messages = parse_header(text, args.list)
+    except SchemaError as e:
+        sys.exit(f'{args.header}: {e}')
+
+    code = generate(args.header, table, messages)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(code)
+    else:
+        sys.stdout.write(code)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,331 @@
+/**
+ * Etherlink parser fuzz target
+ *
+ * The first two input bytes pick the context setup (extended frames, RX
+ * buffer size, handler table, ID filter, checked frames, rescan,
+ * chunking); the rest is the byte
+ * stream. It is parsed twice, once with el_process_byte and once with
+ * el_process_bytes in chunks whose sizes come from the input. The block
+ * fast path promises the same behavior as the byte-wise state machine, so
+ * both runs must deliver exactly the same frames and counters; any
+ * difference aborts. Memory errors are left to the sanitizers, with the
+ * RX buffer on the heap so overruns are caught.
+ *
+ * Built as el_fuzz (libFuzzer, Clang) or el_fuzz_run, a standalone driver
+ * that replays input files or mutates generated frame streams:
+ *
+ *   el_fuzz_run crash-1234              # Replay files
+ *   el_fuzz_run -runs=100000 -seed=7    # Generate and mutate
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EXT_BUF_SIZE    1024
+
+// Everything one parse delivered, folded into a hash
+typedef struct {
+    uint32_t count;
+    uint32_t hash;
+} rx_log_t;
+
+static rx_log_t *cur_log;
+
+static void log_frame(uint8_t msg_id, const uint8_t *payload, size_t len) {
+    uint32_t h = cur_log->hash;
+    uint8_t head[3] = { msg_id, (uint8_t)len, (uint8_t)(len >> 8) };
+
+    for (size_t i = 0; i < sizeof(head); i++) {
+        h = (h ^ head[i]) * 16777619u;
+    }
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ payload[i]) * 16777619u;
+    }
+    cur_log->hash = h;
+    cur_log->count++;
+}
+
+static void on_message(uint8_t msg_id, const void *payload, uint8_t len) {
+    log_frame(msg_id, payload, len);
+}
+
+static void on_message_ext(uint8_t msg_id, const void *payload, size_t len) {
+    if (len > EXT_BUF_SIZE) {
+        abort();
+    }
+    log_frame(msg_id, payload, len);
+}
+
+static void on_handler(void *user, uint8_t msg_id, const void *payload, uint8_t len) {
+    const el_handler_entry_t *table = user;
+    if (len < table[msg_id].min_len) {
+        abort();
+    }
+    log_frame(msg_id, payload, len);
+}
+
+static void discard_sendv(void *user, const el_iovec_t *iov, size_t iovcnt) {
+    (void)user;
+    (void)iov;
+    (void)iovcnt;
+}
+
+typedef struct {
+    el_ctx_t ctx;
+    el_handler_entry_t handlers[EL_HANDLER_TABLE_SIZE];
+    uint8_t *rx_buf;
+    rx_log_t log;
+} parser_t;
+
+static void parser_init(parser_t *p, uint8_t flags, uint8_t arg) {
+    bool ext = flags & 0x01;
+    bool rescan = flags & 0x20;
+    size_t buf_size = (ext && (flags & 0x02) ? EXT_BUF_SIZE : EL_MAX_PAYLOAD) +
+                      (rescan ? EL_RESCAN_SLACK : 0);
+
+    memset(&p->log, 0, sizeof(p->log));
+    p->rx_buf = malloc(buf_size);
+
+    el_config_t config = {
+        .on_message = on_message,
+        .on_message_ext = on_message_ext,
+        .send_bytesv = discard_sendv,
+        .handlers = (flags & 0x04) ? p->handlers : NULL,
+        .ext_frames = ext,
+        .frame_crc = (flags & 0x10) ? EL_CRC_32 : EL_CRC_8,
+        .rescan = rescan,
+        .rx_buffer = p->rx_buf,
+        .rx_buffer_size = buf_size,
+    };
+    if (!el_init(&p->ctx, &config)) {
+        abort();
+    }
+
+    if (flags & 0x04) {
+        // Every 4th ID gets a handler with a length floor
+        for (unsigned id = arg & 3; id < EL_HANDLER_TABLE_SIZE; id += 4) {
+            el_register_handler(&p->ctx, (uint8_t)id, on_handler, p->handlers, (uint8_t)(id ^ arg));
+        }
+    }
+    if (flags & 0x08) {
+        el_set_filter(&p->ctx, arg, (uint8_t)(arg | 0x0F), true);
+    }
+}
+
+static void check_state(const el_ctx_t *ctx) {
+    if (ctx->state > EL_STATE_SKIP || ctx->payload_idx > ctx->rx_buf_size) {
+        abort();
+    }
+}
+
+static void run(const uint8_t *data, size_t size) {
+    if (size < 2) {
+        return;
+    }
+
+    uint8_t flags = data[0];
+    uint8_t arg = data[1];
+    const uint8_t *stream = data + 2;
+    size_t len = size - 2;
+
+    static parser_t a, b;
+    parser_init(&a, flags, arg);
+    parser_init(&b, flags, arg);
+
+    cur_log = &a.log;
+    for (size_t i = 0; i < len; i++) {
+        el_process_byte(&a.ctx, stream[i]);
+        check_state(&a.ctx);
+    }
+
+    // Chunk sizes from a generator seeded by the setup bytes: 1..64 bytes,
+    // or the whole rest when the top flag bit says so
+    uint32_t rng = ((uint32_t)flags << 8 | arg) + 1;
+    cur_log = &b.log;
+    for (size_t off = 0; off < len;) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        size_t n = (flags & 0x80) && (rng & 3) == 0 ? len - off : 1 + (rng & 63);
+        if (n > len - off) {
+            n = len - off;
+        }
+        el_process_bytes(&b.ctx, stream + off, n);
+        check_state(&b.ctx);
+        off += n;
+    }
+
+    if (a.log.count != b.log.count || a.log.hash != b.log.hash ||
+        a.ctx.rx_frames != b.ctx.rx_frames || a.ctx.rx_errors != b.ctx.rx_errors ||
+        a.ctx.rx_filtered != b.ctx.rx_filtered || a.ctx.rx_unhandled != b.ctx.rx_unhandled ||
+        a.ctx.rx_bad_length != b.ctx.rx_bad_length || a.ctx.rx_crc_errors != b.ctx.rx_crc_errors ||
+        a.ctx.rx_len_errors != b.ctx.rx_len_errors ||
+        a.ctx.rx_sync_discarded != b.ctx.rx_sync_discarded || a.ctx.rx_bytes != b.ctx.rx_bytes ||
+        a.ctx.state != b.ctx.state) {
+        fprintf(stderr, "byte-wise and block parse differ: frames %u/%u errors %u/%u "
+                "discarded %u/%u state %d/%d\n",
+                (unsigned)a.log.count, (unsigned)b.log.count, (unsigned)a.ctx.rx_errors,
+                (unsigned)b.ctx.rx_errors, (unsigned)a.ctx.rx_sync_discarded,
+                (unsigned)b.ctx.rx_sync_discarded, a.ctx.state, b.ctx.state);
+        abort();
+    }
+
+    free(a.rx_buf);
+    free(b.rx_buf);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    run(data, size);
+    return 0;
+}
+
+#ifdef EL_FUZZ_STANDALONE
+
+/*******************************************************************************
+ * Standalone Driver
+ ******************************************************************************/
+
+static uint32_t rng_state = 1;
+
+static uint32_t rnd(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Append one well-formed frame (standard, or extended or checked if allowed)
+static size_t gen_frame(uint8_t *out, size_t room, bool ext, bool checked) {
+    size_t len = ext && (rnd() & 1) ? rnd() % EXT_BUF_SIZE : rnd() % (EL_MAX_PAYLOAD + 1);
+    uint8_t sync = len > EL_MAX_PAYLOAD ? EL_SYNC_EXT : EL_SYNC_BYTE;
+    if (sync == EL_SYNC_BYTE && checked && (rnd() & 1)) {
+        sync = (rnd() & 1) ? EL_SYNC_CRC32 : EL_SYNC_CRC16;
+    }
+    size_t hdr_len = sync == EL_SYNC_BYTE ? 3 : 4;
+    size_t total = len + (sync == EL_SYNC_BYTE ? EL_FRAME_OVERHEAD :
+                          sync == EL_SYNC_CRC32 ? EL_CHK32_OVERHEAD : EL_EXT_OVERHEAD);
+
+    if (room < total) {
+        return 0;
+    }
+
+    out[0] = sync;
+    out[1] = (uint8_t)rnd();
+    out[2] = (uint8_t)len;
+    if (sync == EL_SYNC_EXT) {
+        out[3] = (uint8_t)(len >> 8);
+    } else if (hdr_len == 4) {
+        out[3] = el_crc8(out, 3);
+    }
+    for (size_t i = 0; i < len; i++) {
+        out[hdr_len + i] = (uint8_t)rnd();
+    }
+
+    // CRC covers everything after the sync byte; CRC-16 is sent MSB first,
+    // CRC-32 LSB first
+    uint8_t *crc = &out[hdr_len + len];
+    if (sync == EL_SYNC_CRC32) {
+        uint32_t sum = el_crc32(&out[1], 3 + len);
+        for (int i = 0; i < 4; i++) {
+            crc[i] = (uint8_t)(sum >> (8 * i));
+        }
+    } else if (hdr_len == 4) {
+        uint16_t sum = el_crc16(&out[1], 3 + len);
+        crc[0] = (uint8_t)(sum >> 8);
+        crc[1] = (uint8_t)sum;
+    } else {
+        crc[0] = el_crc8(&out[1], 2 + len);
+    }
+    return total;
+}
+
+static size_t gen_input(uint8_t *buf, size_t cap) {
+    size_t n = 0;
+    buf[n++] = (uint8_t)rnd();
+    buf[n++] = (uint8_t)rnd();
+    bool ext = buf[0] & 0x01;
+    bool checked = buf[0] & 0x10;
+
+    unsigned frames = 1 + rnd() % 16;
+    for (unsigned i = 0; i < frames; i++) {
+        // Noise between frames, often containing sync bytes
+        unsigned noise = rnd() % 8;
+        for (unsigned j = 0; j < noise && n < cap; j++) {
+            uint32_t r = rnd();
+            static const uint8_t syncs[4] = { EL_SYNC_BYTE, EL_SYNC_EXT, EL_SYNC_CRC16, EL_SYNC_CRC32 };
+            buf[n++] = (r & 15) < 4 ? syncs[r & 3] : (uint8_t)(r >> 8);
+        }
+        n += gen_frame(&buf[n], cap - n, ext, checked);
+    }
+
+    // Corrupt, drop or duplicate a few bytes
+    unsigned edits = rnd() % 4;
+    for (unsigned i = 0; i < edits && n > 2; i++) {
+        size_t at = 2 + rnd() % (n - 2);
+        switch (rnd() % 3) {
+            case 0:
+                buf[at] ^= (uint8_t)(1u << (rnd() & 7));
+                break;
+            case 1:
+                memmove(&buf[at], &buf[at + 1], n - at - 1);
+                n--;
+                break;
+            default:
+                if (n < cap) {
+                    memmove(&buf[at + 1], &buf[at], n - at);
+                    n++;
+                }
+                break;
+        }
+    }
+    return n;
+}
+
+static int replay(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    static uint8_t buf[1 << 20];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    run(buf, n);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    unsigned long runs = 0;
+    int files = 0;
+    int ret = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "-runs=", 6) == 0) {
+            runs = strtoul(argv[i] + 6, NULL, 0);
+        } else if (strncmp(argv[i], "-seed=", 6) == 0) {
+            rng_state = (uint32_t)strtoul(argv[i] + 6, NULL, 0) | 1;
+        } else {
+            ret |= replay(argv[i]);
+            files++;
+        }
+    }
+    if (files == 0 && runs == 0) {
+        runs = 10000;
+    }
+
+    static uint8_t buf[64 * 1024];
+    for (unsigned long i = 0; i < runs; i++) {
+        size_t n = gen_input(buf, sizeof(buf));
+        run(buf, n);
+    }
+
+    printf("%d file(s), %lu generated input(s): OK\n", files, runs);
+    return ret;
+}
+
+#endif // EL_FUZZ_STANDALONE
@@ -0,0 +1,421 @@
+/**
+ * Etherlink core benchmarks (workstation)
+ *
+ * Times el_crc8/el_crc16/el_crc32, el_send (direct and through the TX
+ * ring) and el_process_bytes across payload sizes and line noise rates,
+ * for standard and CRC-32 checked frames, plus every CRC-8 kernel side by
+ * side, so
+ * throughput regressions show up before anything is flashed:
+ *
+ *   el_perf                      # All benchmarks, table output
+ *   el_perf --filter=parse       # Names containing "parse"
+ *   el_perf --csv > before.csv   # For diffing two builds
+ *   el_perf --min-ms=500         # Longer runs, steadier numbers
+ *   el_perf --ghz=3.2            # Clock for the B/cycle column
+ *
+ * Each benchmark is calibrated to run for at least min-ms, repeated three
+ * times, and the fastest repeat is reported. ns/op is per frame for send
+ * and parse, per call for the CRCs. B/cycle divides throughput by the CPU
+ * clock: --ghz, or on x86 the TSC rate, which is the nominal clock and
+ * ignores turbo, so pin the frequency for exact numbers.
+ *
+ * MIT License - https://github.com/user/etherlink
+ */
+
+#include "etherlink.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define REPEATS         3
+#define STREAM_FRAMES   512
+#define CHUNK_SIZE      64      // Parser input per call, like a transport read
+
+static unsigned min_ms = 200;
+static const char *filter = NULL;
+static bool csv = false;
+static double cpu_ghz = 0;      // 0 = unknown, no B/cycle
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Keeps results alive so the compiler cannot drop the work
+static volatile uint32_t sink;
+
+// TSC ticks per ns, where there is a TSC
+static double tsc_ghz(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    double t0 = now_ns();
+    uint64_t c0 = __rdtsc();
+    while (now_ns() - t0 < 50e6) {
+    }
+    return (double)(__rdtsc() - c0) / (now_ns() - t0);
+#else
+    return 0;
+#endif
+}
+
+/*******************************************************************************
+ * Runner
+ ******************************************************************************/
+
+typedef void (*bench_fn_t)(void *arg, uint64_t iters);
+
+// Runs fn until it takes min_ms, then reports the best of REPEATS.
+// bytes_per_iter and frames_per_iter scale the throughput columns.
+static void bench(const char *name, const char *param, bench_fn_t fn, void *arg,
+                  double bytes_per_iter, double frames_per_iter) {
+    char full[96];
+    snprintf(full, sizeof(full), "%s/%s", name, param);
+    if (filter && !strstr(full, filter)) {
+        return;
+    }
+
+    uint64_t iters = 1;
+    for (;;) {
+        double t0 = now_ns();
+        fn(arg, iters);
+        double dt = now_ns() - t0;
+        if (dt >= min_ms * 1e6 || iters >= (1ull << 40)) {
+            break;
+        }
+        iters = dt < min_ms * 1e5 ? iters * 10 : (uint64_t)(iters * (min_ms * 1.2e6 / dt)) + 1;
+    }
+
+    double best = 0;
+    for (int r = 0; r < REPEATS; r++) {
+        double t0 = now_ns();
+        fn(arg, iters);
+        double dt = (now_ns() - t0) / (double)iters;
+        if (r == 0 || dt < best) {
+            best = dt;
+        }
+    }
+
+    double mbps = bytes_per_iter > 0 ? bytes_per_iter / best * 1e3 : 0;  // MB/s
+    double ns_frame = frames_per_iter > 0 ? best / frames_per_iter : best;
+    double bpc = cpu_ghz > 0 ? mbps / (cpu_ghz * 1e3) : 0;                // B/cycle
+    if (csv) {
+        printf("%s,%s,%.2f,%.1f,%.3f\n", name, param, ns_frame, mbps, bpc);
+    } else {
+        printf("%-22s %-18s %12.1f %12.1f %10.3f\n", name, param, ns_frame, mbps, bpc);
+    }
+    fflush(stdout);
+}
+
+/*******************************************************************************
+ * CRC
+ ******************************************************************************/
+
+typedef struct {
+    uint8_t data[4096];
+    size_t len;
+} crc_arg_t;
+
+static void run_crc8(void *arg, uint64_t iters) {
+    crc_arg_t *a = arg;
+    uint32_t acc = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        a->data[0] = (uint8_t)i;
+        acc += el_crc8(a->data, a->len);
+    }
+    sink = acc;
+}
+
+static void run_crc16(void *arg, uint64_t iters) {
+    crc_arg_t *a = arg;
+    uint32_t acc = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        a->data[0] = (uint8_t)i;
+        acc += el_crc16(a->data, a->len);
+    }
+    sink = acc;
+}
+
+static void run_crc32(void *arg, uint64_t iters) {
+    crc_arg_t *a = arg;
+    uint32_t acc = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        a->data[0] = (uint8_t)i;
+        acc += el_crc32(a->data, a->len);
+    }
+    sink = acc;
+}
+
+#if EL_CRC8_BENCH
+typedef struct {
+    crc_arg_t *crc;
+    int impl;
+} kernel_arg_t;
+
+static void run_crc8_kernel(void *arg, uint64_t iters) {
+    kernel_arg_t *a = arg;
+    uint32_t acc = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        a->crc->data[0] = (uint8_t)i;
+        acc += el_crc8_kernel(a->impl, a->crc->data, a->crc->len);
+    }
+    sink = acc;
+}
+#endif
+
+/*******************************************************************************
+ * Send
+ ******************************************************************************/
+
+static void null_sendv(void *user, const el_iovec_t *iov, size_t iovcnt) {
+    (void)user;
+    size_t n = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        n += iov[i].len;
+    }
+    sink += (uint32_t)n;
+}
+
+static void null_on_message(uint8_t msg_id, const void *payload, uint8_t len) {
+    (void)msg_id;
+    (void)payload;
+    sink += len;
+}
+
+typedef struct {
+    el_ctx_t ctx;
+    uint8_t payload[EL_MAX_PAYLOAD];
+    uint8_t len;
+} send_arg_t;
+
+static void run_send(void *arg, uint64_t iters) {
+    send_arg_t *a = arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        el_send(&a->ctx, 0x10, a->payload, a->len);
+    }
+}
+
+// Enqueue and drain again, as a transport's sender task would
+static void run_send_ring(void *arg, uint64_t iters) {
+    send_arg_t *a = arg;
+    el_iovec_t span[2];
+    size_t count;
+
+    for (uint64_t i = 0; i < iters; i++) {
+        el_send(&a->ctx, 0x10, a->payload, a->len);
+        if (el_tx_claim(&a->ctx, span, &count) > 0) {
+            sink += (uint32_t)span[0].len;
+            el_tx_release(&a->ctx);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Parse
+ ******************************************************************************/
+
+typedef struct {
+    el_ctx_t ctx;
+    uint8_t *stream;
+    size_t len;
+    bool bytewise;
+} parse_arg_t;
+
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rnd(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint8_t *capture;
+static size_t capture_len;
+
+static void capture_sendv(void *user, const el_iovec_t *iov, size_t iovcnt) {
+    (void)user;
+    for (size_t i = 0; i < iovcnt; i++) {
+        memcpy(capture + capture_len, iov[i].data, iov[i].len);
+        capture_len += iov[i].len;
+    }
+}
+
+// STREAM_FRAMES frames of one size and frame type; each byte then has one
+// bit flipped with probability noise_ppm / 1e6
+static size_t build_stream(uint8_t *out, uint8_t len, uint32_t noise_ppm, el_crc_t crc) {
+    el_ctx_t tx;
+    el_config_t config = { .on_message = null_on_message, .send_bytesv = capture_sendv };
+    uint8_t payload[EL_MAX_PAYLOAD];
+
+    el_init(&tx, &config);
+    el_set_tx_crc(&tx, crc);
+    capture = out;
+    capture_len = 0;
+    for (unsigned f = 0; f < STREAM_FRAMES; f++) {
+        for (size_t i = 0; i < len; i++) {
+            payload[i] = (uint8_t)rnd();
+        }
+        el_send(&tx, (uint8_t)(0x10 + f % 32), payload, len);
+    }
+
+    for (size_t i = 0; i < capture_len && noise_ppm > 0; i++) {
+        if (rnd() % 1000000 < noise_ppm) {
+            out[i] ^= (uint8_t)(1u << (rnd() & 7));
+        }
+    }
+    return capture_len;
+}
+
+static void run_parse(void *arg, uint64_t iters) {
+    parse_arg_t *a = arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        if (a->bytewise) {
+            for (size_t j = 0; j < a->len; j++) {
+                el_process_byte(&a->ctx, a->stream[j]);
+            }
+        } else {
+            for (size_t off = 0; off < a->len; off += CHUNK_SIZE) {
+                size_t n = a->len - off < CHUNK_SIZE ? a->len - off : CHUNK_SIZE;
+                el_process_bytes(&a->ctx, a->stream + off, n);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+
+static const uint8_t sizes[] = { 0, 16, 64, 128, 250 };
+static const uint32_t noise_ppm[] = { 0, 1000, 10000 };     // 0, 0.1%, 1% of bytes
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--min-ms=", 9) == 0) {
+            min_ms = (unsigned)strtoul(argv[i] + 9, NULL, 0);
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strncmp(argv[i], "--ghz=", 6) == 0) {
+            cpu_ghz = strtod(argv[i] + 6, NULL);
+        } else {
+            fprintf(stderr, "usage: %s [--filter=substr] [--min-ms=N] [--ghz=F] [--csv]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (cpu_ghz <= 0) {
+        cpu_ghz = tsc_ghz();
+    }
+
+    if (csv) {
+        printf("benchmark,param,ns_per_op,mb_per_s,b_per_cycle\n");
+    } else {
+        printf("%-22s %-18s %12s %12s %10s\n", "benchmark", "param", "ns/op", "MB/s", "B/cycle");
+    }
+
+    char param[32];
+    static crc_arg_t crc;
+    for (size_t i = 0; i < sizeof(crc.data); i++) {
+        crc.data[i] = (uint8_t)rnd();
+    }
+    static const size_t crc_sizes[] = { 8, 64, 250, 1024, 4096 };
+    for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+        crc.len = crc_sizes[i];
+        snprintf(param, sizeof(param), "%zu B", crc.len);
+        bench("el_crc8", param, run_crc8, &crc, (double)crc.len, 1);
+    }
+    for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+        crc.len = crc_sizes[i];
+        snprintf(param, sizeof(param), "%zu B", crc.len);
+        bench("el_crc16", param, run_crc16, &crc, (double)crc.len, 1);
+    }
+    for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+        crc.len = crc_sizes[i];
+        snprintf(param, sizeof(param), "%zu B", crc.len);
+        bench("el_crc32", param, run_crc32, &crc, (double)crc.len, 1);
+    }
+#if EL_CRC8_BENCH
+    // Every CRC-8 kernel in this one binary, whichever frames use
+    static const char *const kernel_names[EL_CRC8_KERNELS] = {
+        "table", "slice4", "slice8", "bitwise",
+    };
+    for (int k = 0; k < EL_CRC8_KERNELS; k++) {
+        kernel_arg_t kernel = { .crc = &crc, .impl = k };
+        for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+            crc.len = crc_sizes[i];
+            snprintf(param, sizeof(param), "%s, %zu B", kernel_names[k], crc.len);
+            bench("el_crc8_kernel", param, run_crc8_kernel, &kernel, (double)crc.len, 1);
+        }
+    }
+#endif
+
+    static send_arg_t send;
+    static uint8_t ring[4096];
+    for (size_t i = 0; i < sizeof(sizes); i++) {
+        el_config_t config = { .on_message = null_on_message, .send_bytesv = null_sendv };
+        el_init(&send.ctx, &config);
+        send.len = sizes[i];
+        snprintf(param, sizeof(param), "%u B", (unsigned)send.len);
+        bench("el_send", param, run_send, &send, send.len + EL_FRAME_OVERHEAD, 1);
+    }
+    for (size_t i = 0; i < sizeof(sizes); i++) {
+        el_config_t config = {
+            .on_message = null_on_message,
+            .tx_ring = ring,
+            .tx_ring_size = sizeof(ring),
+        };
+        el_init(&send.ctx, &config);
+        send.len = sizes[i];
+        snprintf(param, sizeof(param), "%u B", (unsigned)send.len);
+        bench("el_send (TX ring)", param, run_send_ring, &send, send.len + EL_FRAME_OVERHEAD, 1);
+    }
+
+    static parse_arg_t parse;
+    static uint8_t stream[STREAM_FRAMES * EL_MAX_FRAME];
+    el_config_t rx_config = { .on_message = null_on_message, .send_bytesv = null_sendv };
+    for (size_t i = 0; i < sizeof(sizes); i++) {
+        for (size_t n = 0; n < sizeof(noise_ppm) / sizeof(noise_ppm[0]); n++) {
+            el_init(&parse.ctx, &rx_config);
+            parse.stream = stream;
+            parse.len = build_stream(stream, sizes[i], noise_ppm[n], EL_CRC_8);
+            parse.bytewise = false;
+            snprintf(param, sizeof(param), "%u B, %.1f%% noise", (unsigned)sizes[i],
+                     noise_ppm[n] / 1e4);
+            bench("el_process_bytes", param, run_parse, &parse, (double)parse.len, STREAM_FRAMES);
+        }
+    }
+    el_config_t chk_config = {
+        .on_message = null_on_message,
+        .send_bytesv = null_sendv,
+        .frame_crc = EL_CRC_32,
+        .rescan = true,
+    };
+    for (size_t i = 0; i < sizeof(sizes); i++) {
+        for (size_t n = 0; n < sizeof(noise_ppm) / sizeof(noise_ppm[0]); n++) {
+            el_init(&parse.ctx, &chk_config);
+            parse.stream = stream;
+            parse.len = build_stream(stream, sizes[i], noise_ppm[n], EL_CRC_32);
+            parse.bytewise = false;
+            snprintf(param, sizeof(param), "%u B, %.1f%% noise", (unsigned)sizes[i],
+                     noise_ppm[n] / 1e4);
+            bench("el_process_bytes crc32", param, run_parse, &parse, (double)parse.len,
+                  STREAM_FRAMES);
+        }
+    }
+    for (size_t i = 0; i < sizeof(sizes); i++) {
+        el_init(&parse.ctx, &rx_config);
+        parse.stream = stream;
+        parse.len = build_stream(stream, sizes[i], 0, EL_CRC_8);
+        parse.bytewise = true;
+        snprintf(param, sizeof(param), "%u B", (unsigned)sizes[i]);
+        bench("el_process_byte", param, run_parse, &parse, (double)parse.len, STREAM_FRAMES);
+    }
+
+    return 0;
+}